@@ -302,6 +302,11 @@ int main(int argc, char* argv[])
 	program.add_argument("--template")
 		.help("When passed with create use a specific project template");
 
+	program.add_argument("--no-bytecode-cache")
+		.help("Parse every script from source, compare the startup time it logs against a normal run")
+		.default_value(false)
+		.implicit_value(true);
+
 	std::string cmd = "";
 	try
 	{
@@ -316,6 +321,9 @@ int main(int argc, char* argv[])
 
 	if (cmd == "run")
 	{
+		if (program.get<bool>("--no-bytecode-cache"))
+			latte::setBytecodeCacheEnabled(false);
+
 		const std::string file = program.get<std::string>("arg");
 
 		if (!file.empty())
@@ -89,8 +89,9 @@ void latteFreeNode(LatteNode* node)
 
 	latteOrphanNode(node);
 
-	for (int i = 0; i < node->childCount; i++)
-		latteFreeNode(node->children[i]);
+	// Each child orphans itself, so free from the back to keep the array from shifting under the loop
+	while (node->childCount > 0)
+		latteFreeNode(node->children[node->childCount - 1]);
 
 	free(node->children);
 	node->childCapacity = 0;
@@ -109,6 +110,36 @@ void latteFreeNode(LatteNode* node)
 	free(node);
 }
 
+void latteResetNode(LatteNode* node)
+{
+	assert(node);
+	assert(node->parent == NULL && node->childCount == 0);
+
+	LatteNode** children = node->children;
+	int childCapacity = node->childCapacity;
+	void* userPtr = node->userPtr;
+	LatteUserDataDeleter deleter = node->userDataDeleter;
+	int flags = node->flags;
+
+	if (node->id)
+		free(node->id);
+
+	memset(node, 0, sizeof(LatteNode));
+
+	node->children = children;
+	node->childCapacity = childCapacity;
+	node->userPtr = userPtr;
+	node->userDataDeleter = deleter;
+	node->flags = flags;
+
+	node->layoutDirection = LATTE_DIRECTION_HORIZONTAL;
+	node->crossAxisAlignment = LATTE_CONTENT_START;
+	node->mainAxisAlignment = LATTE_CONTENT_START;
+
+	latteRelativePositioner(node);
+	lattePropogateDirty(node);
+}
+
 void latteUserData(LatteNode* node, void* userData)
 {
 	assert(node);
@@ -167,6 +198,73 @@ void latteNodeAddChild(LatteNode* node, LatteNode* child)
 	lattePropogateDirty(node);
 }
 
+static int latteReserveChildren(LatteNode* node, int count)
+{
+	if (count <= node->childCapacity)
+		return 1;
+
+	int newCapacity = node->childCapacity ? node->childCapacity * 2 : 2;
+	if (newCapacity < count)
+		newCapacity = count;
+
+	LatteNode** newChildren = (LatteNode**)realloc(node->children, newCapacity * sizeof(LatteNode*));
+
+	if (!newChildren)
+		return 0;
+
+	node->childCapacity = newCapacity;
+	node->children = newChildren;
+
+	return 1;
+}
+
+static void latteSetAncestorsDirty(LatteNode* node)
+{
+	for (LatteNode* n = node; n != NULL; n = n->parent)
+		n->dirty = 1;
+}
+
+void latteNodeInsertChild(LatteNode* node, LatteNode* child, int index)
+{
+	assert(node);
+	assert(child);
+
+	if (!latteReserveChildren(node, node->childCount + 1))
+		return;
+
+	if (index < 0 || index > node->childCount)
+		index = node->childCount;
+
+	memmove(&node->children[index + 1], &node->children[index], (node->childCount - index) * sizeof(LatteNode*));
+
+	child->parent = node;
+	node->children[index] = child;
+	node->childCount++;
+
+	// Siblings keep their layout inputs, only the path down to the new child needs redoing
+	lattePropogateDirty(child);
+	latteSetAncestorsDirty(node);
+}
+
+void latteNodeMoveChild(LatteNode* node, int from, int to)
+{
+	assert(node);
+
+	if (from < 0 || from >= node->childCount || to < 0 || to >= node->childCount || from == to)
+		return;
+
+	LatteNode* child = node->children[from];
+
+	if (from < to)
+		memmove(&node->children[from], &node->children[from + 1], (to - from) * sizeof(LatteNode*));
+	else
+		memmove(&node->children[to + 1], &node->children[to], (from - to) * sizeof(LatteNode*));
+
+	node->children[to] = child;
+
+	latteSetAncestorsDirty(node);
+}
+
 void latteOrphanNode(LatteNode* node)
 {
 	if (!node || !node->parent)
@@ -176,7 +274,8 @@ void latteOrphanNode(LatteNode* node)
 	int foundIdx = -1;
 
 	// Find this node in its parent's children array
-	for (int i = 0; i < parent->childCount; ++i)
+	// Searched from the back since children are usually removed last first
+	for (int i = parent->childCount - 1; i >= 0; --i)
 	{
 		if (parent->children[i] == node)
 		{
@@ -201,6 +300,25 @@ void latteOrphanNode(LatteNode* node)
 	node->parent = NULL;
 }
 
+void latteOrphanChildren(LatteNode* node, int index, int count, LatteNode** out)
+{
+	assert(node);
+
+	if (index < 0 || count <= 0 || index + count > node->childCount)
+		return;
+
+	for (int i = 0; i < count; i++)
+	{
+		out[i] = node->children[index + i];
+		out[i]->parent = NULL;
+	}
+
+	memmove(&node->children[index], &node->children[index + count], (node->childCount - index - count) * sizeof(LatteNode*));
+	node->childCount -= count;
+
+	latteSetAncestorsDirty(node);
+}
+
 void latteMainAxisDirection(LatteNode* node, LatteLayoutDirection dir)
 {
 	NODE_ASSIGN_VAL(layoutDirection, dir)
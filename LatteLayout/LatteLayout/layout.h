@@ -193,6 +193,12 @@ LatteNode* latteCreateNode(const char* id, LatteNode* parent, int flags);
 */
 void latteFreeNode(LatteNode* node);
 
+/*
+	Puts an orphaned node with no children back to the state latteCreateNode leaves it in,
+	so it can be reused instead of freed. The children array, user data and flags are kept
+*/
+void latteResetNode(LatteNode* node);
+
 typedef void(*PropogateFunc)(LatteNode* node);
 
 void lattePropogate(LatteNode* node, PropogateFunc func);
@@ -228,8 +234,25 @@ void latteNodeAddFlags(LatteNode* node, int flags);
 */
 void latteNodeAddChild(LatteNode* node, LatteNode* child);
 
+/*
+	Insert a child at an index, an out of range index appends it
+
+	Only the new child's subtree and its ancestors are marked dirty
+*/
+void latteNodeInsertChild(LatteNode* node, LatteNode* child, int index);
+
+/*
+	Move a child from one index to another, shifting the children in between
+*/
+void latteNodeMoveChild(LatteNode* node, int from, int to);
+
 void latteOrphanNode(LatteNode* node);
 
+/*
+	Orphan count children starting at index in one go, they are written to out so they can be freed or reattached
+*/
+void latteOrphanChildren(LatteNode* node, int index, int count, LatteNode** out);
+
 /*
 	Set the main axis direction for laying out children
 */
@@ -0,0 +1,182 @@
+#include "BaseHelpers.h"
+
+namespace latte
+{
+	// Parsed colors kept before the cache is dropped and started again, stops generated color strings growing it forever
+	static constexpr int HEX_CACHE_LIMIT = 1024;
+
+	// Copies every key in the table at index into the table at result
+	static void copyTable(lua_State* L, int index, int result)
+	{
+		lua_pushnil(L);
+		while (lua_next(L, index) != 0)
+		{
+			// key, value -> key, key, value so rawset leaves the key for the next lua_next
+			lua_pushvalue(L, -2);
+			lua_insert(L, -2);
+			lua_rawset(L, result);
+		}
+	}
+
+	// latte.mergeStyles(style1, style2)
+	static int mergeStyles(lua_State* L)
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		luaL_checktype(L, 2, LUA_TTABLE);
+
+		lua_createtable(L, 0, 8);
+		copyTable(L, 1, 3);
+		copyTable(L, 2, 3);
+
+		return 1;
+	}
+
+	// latte.mergeProps(base, exclude, extra)
+	static int mergeProps(lua_State* L)
+	{
+		luaL_checktype(L, 1, LUA_TTABLE);
+		luaL_checktype(L, 2, LUA_TTABLE);
+		luaL_checktype(L, 3, LUA_TTABLE);
+
+		lua_createtable(L, 0, 8);
+		copyTable(L, 1, 4);
+
+		// The exclude list is a handful of names, scanning it is cheaper than building a set
+		const int excludeCount = (int)lua_objlen(L, 2);
+
+		lua_pushnil(L);
+		while (lua_next(L, 3) != 0)
+		{
+			bool skip = false;
+
+			// Already set by base
+			lua_pushvalue(L, -2);
+			lua_rawget(L, 4);
+			skip = !lua_isnil(L, -1);
+			lua_pop(L, 1);
+
+			for (int i = 1; i <= excludeCount && !skip; i++)
+			{
+				lua_rawgeti(L, 2, i);
+				skip = lua_rawequal(L, -1, -3) != 0;
+				lua_pop(L, 1);
+			}
+
+			if (skip)
+			{
+				lua_pop(L, 1);
+				continue;
+			}
+
+			lua_pushvalue(L, -2);
+			lua_insert(L, -2);
+			lua_rawset(L, 4);
+		}
+
+		return 1;
+	}
+
+	static int hexDigit(char c)
+	{
+		if (c >= '0' && c <= '9') return c - '0';
+		if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+		if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+		return -1;
+	}
+
+	// "#RGB", "#RGBA", "#RRGGBB" or "#RRGGBBAA", the # is optional
+	static bool parseHexColor(const char* hex, size_t length, lua_Number out[4])
+	{
+		if (length > 0 && hex[0] == '#')
+		{
+			hex++;
+			length--;
+		}
+
+		if (length != 3 && length != 4 && length != 6 && length != 8)
+			return false;
+
+		// One or two digits per channel
+		const size_t digits = length > 4 ? 2 : 1;
+		const size_t channels = length / digits;
+		const lua_Number scale = digits == 2 ? 255.0 : 15.0;
+
+		out[3] = 1.0;
+		for (size_t i = 0; i < channels; i++)
+		{
+			int value = 0;
+			for (size_t d = 0; d < digits; d++)
+			{
+				int digit = hexDigit(hex[i * digits + d]);
+				if (digit < 0)
+					return false;
+
+				value = value * 16 + digit;
+			}
+
+			out[i] = value / scale;
+		}
+
+		return true;
+	}
+
+	// latte.color.hex(str), upvalue 1 is the cache from string to color and upvalue 2 its size
+	static int colorHex(lua_State* L)
+	{
+		size_t length = 0;
+		const char* hex = luaL_checklstring(L, 1, &length);
+
+		lua_pushvalue(L, 1);
+		lua_rawget(L, lua_upvalueindex(1));
+		if (!lua_isnil(L, -1))
+			return 1;
+		lua_pop(L, 1);
+
+		lua_Number color[4];
+		if (!parseHexColor(hex, length, color))
+			return luaL_error(L, "Invalid hex color format");
+
+		lua_createtable(L, 4, 0);
+		for (int i = 0; i < 4; i++)
+		{
+			lua_pushnumber(L, color[i]);
+			lua_rawseti(L, -2, i + 1);
+		}
+
+		int count = (int)lua_tointeger(L, lua_upvalueindex(2));
+		if (count >= HEX_CACHE_LIMIT)
+		{
+			lua_createtable(L, 0, HEX_CACHE_LIMIT);
+			lua_replace(L, lua_upvalueindex(1));
+			count = 0;
+		}
+
+		lua_pushvalue(L, 1);
+		lua_pushvalue(L, -2);
+		lua_rawset(L, lua_upvalueindex(1));
+
+		lua_pushinteger(L, count + 1);
+		lua_replace(L, lua_upvalueindex(2));
+
+		return 1;
+	}
+
+	void bindBaseHelpers(sol::state_view state, sol::table latteTable)
+	{
+		lua_State* L = state.lua_state();
+
+		latteTable["mergeStyles"] = &mergeStyles;
+		latteTable["mergeProps"] = &mergeProps;
+
+		sol::table color = state.create_table();
+		latteTable["color"] = color;
+
+		// Pushed by hand, sol has no way to give a C function upvalues
+		color.push();
+		lua_createtable(L, 0, 64);
+		lua_pushinteger(L, 0);
+		lua_pushcclosure(L, &colorHex, 2);
+		lua_setfield(L, -2, "hex");
+		lua_pop(L, 1);
+	}
+}
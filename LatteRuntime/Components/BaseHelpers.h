@@ -0,0 +1,19 @@
+#ifndef LATTE_BASE_HELPERS_H
+#define LATTE_BASE_HELPERS_H
+
+#include <sol/sol.hpp>
+
+namespace latte
+{
+	/*
+		Native versions of the helpers in latte-base.lua that run on every render,
+		latte.mergeStyles, latte.mergeProps and latte.color.hex.
+
+		latte-base.lua only defines its own versions if these are missing.
+		latte.color.hex results are cached by string, so the same color table is returned every time.
+		Treat it as read only
+	*/
+	void bindBaseHelpers(sol::state_view state, sol::table latteTable);
+}
+
+#endif // LATTE_BASE_HELPERS_H
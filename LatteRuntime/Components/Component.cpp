@@ -3,37 +3,131 @@
 #include <nanovg.h>
 #include "../Utils/Log.h"
 #include "../OS/EventLoop.h"
-#include <set>
+#include "../Utils/LuaHelpers.h"
+#include "VNode.h"
+#include <unordered_set>
+#include <algorithm>
 
 void latteWidgetDataDeleter(void* usrData)
 {
 	latte::ComponentData* data = (latte::ComponentData*)usrData;
+	latte::ComponentSystem::getInstance().onComponentDataDestroyed(data);
 	delete data;
 }
 
 namespace latte
 {
-	sol::protected_function ComponentSystem::getComponent(const std::string& name)
-	{
+    ComponentSystem::~ComponentSystem()
+    {
+        // Pooled nodes were torn down when they were recycled and hold no Lua references, only their memory is left.
+        // Their data is deleted here so freeing them doesn't call back into a system that is going away
+        for (std::vector<LatteNode*>& pool : m_NodePool)
+        {
+            for (LatteNode* node : pool)
+            {
+                delete (ComponentData*)latteGetUserData(node);
+                node->userDataDeleter = nullptr;
+                node->flags &= ~LATTE_NODE_FLAGS_DELETE_USERDATA;
+                latteFreeNode(node);
+            }
+        }
+    }
 
-        int firstDot = name.find_first_of('.');
-        std::string lib = name.substr(0, firstDot);
-        std::string compName = name.substr(firstDot + 1);
+    ComponentTypeId ComponentSystem::registerComponentType(const std::string& name, sol::protected_function ctor)
+    {
+        auto itr = m_ComponentTypeIds.find(name);
+        if (itr != m_ComponentTypeIds.end())
+        {
+            m_ComponentTypes[itr->second].ctor = ctor;
+            return itr->second;
+        }
+
+        ComponentType type;
+        type.name = name;
+        type.nameHash = hashString(name);
+        type.ctor = ctor;
+
+        auto native = m_NativeWidgets.find(name);
+        if (native != m_NativeWidgets.end())
+            type.widgetType = native->second;
+
+        ComponentTypeId id = (ComponentTypeId)m_ComponentTypes.size();
+        m_ComponentTypes.push_back(std::move(type));
+        m_ComponentTypeIds[name] = id;
+
+        return id;
+    }
 
-        auto libItr = m_Libraries.find(lib);
-        if (libItr == m_Libraries.end())
+    void ComponentSystem::registerNativeWidget(const std::string& name, WidgetType type)
+    {
+        m_NativeWidgets[name] = type;
+
+        // Components can be registered before their native widget
+        auto itr = m_ComponentTypeIds.find(name);
+        if (itr != m_ComponentTypeIds.end())
+            m_ComponentTypes[itr->second].widgetType = type;
+    }
+
+	sol::protected_function ComponentSystem::getComponent(const std::string& name)
+	{
+        auto itr = m_ComponentTypeIds.find(name);
+        if (itr == m_ComponentTypeIds.end())
         {
-            Log::log(Log::Severity::Error, "Could not find Component {} in Component Library {} -> Library doesn't exist ", compName, lib);
+            Log::log(Log::Severity::Error, "Could not find Component {}", name);
             return sol::nil;
         }
 
-        return libItr->second->getComponent(compName);
-
+        return m_ComponentTypes[itr->second].ctor;
 	}
 
-    LatteNode* findLatteNode(const std::string& id, LatteNode* node)
+    uint64_t getNodeId(LatteNode* node)
+    {
+        ComponentData* data = (ComponentData*)latteGetUserData(node);
+        if (data != nullptr)
+            return data->id;
+
+        return hashString(node->id ? node->id : "");
+    }
+
+    std::string describeNode(LatteNode* node)
+    {
+        if (node == nullptr)
+            return "<null>";
+
+        std::vector<LatteNode*> path;
+        for (LatteNode* n = node; n != nullptr; n = n->parent)
+            path.push_back(n);
+
+        std::string result;
+        for (auto itr = path.rbegin(); itr != path.rend(); ++itr)
+        {
+            LatteNode* n = *itr;
+            ComponentData* data = (ComponentData*)latteGetUserData(n);
+
+            if (data == nullptr)
+            {
+                result += n->id ? n->id : "<root>";
+                continue;
+            }
+
+            result += "/";
+            if (!data->key.empty())
+            {
+                result += data->key;
+                continue;
+            }
+
+            result += std::to_string(data->childIndex);
+            if (const ComponentType* type = ComponentSystem::getInstance().getComponentType(data->componentType))
+                result += "." + type->name;
+        }
+
+        return result;
+    }
+
+    static LatteNode* findLatteNode(uint64_t id, LatteNode* node)
     {
-        if (std::string(node->id) == id)
+        if (getNodeId(node) == id)
             return node;
 
         for (int i = 0; i < node->childCount; i++)
@@ -47,10 +141,9 @@ namespace latte
         return nullptr;
     }
 
-    LatteNode* ComponentSystem::findNode(const std::string& id)
+    LatteNode* ComponentSystem::findNode(uint64_t id)
     {
         LatteNode* result = nullptr;
-        WindowManager& winMgr = EventLoop::getInstance().getWindowManager();
         EventLoop::getInstance().getWindowManager().foreach(
             [&](std::shared_ptr<Window> win) {
                 if (!result)
@@ -60,113 +153,976 @@ namespace latte
         return result;
     }
 
+    static LatteNode* getRootNode(LatteNode* node)
+    {
+        while (node->parent != nullptr)
+            node = node->parent;
+
+        return node;
+    }
+
+    static bool isNodeInSubtree(LatteNode* node, LatteNode* subtreeRoot)
+    {
+        for (LatteNode* n = node; n != nullptr; n = n->parent)
+        {
+            if (n == subtreeRoot)
+                return true;
+        }
+
+        return false;
+    }
+
+    void ComponentSystem::enqueueWork(LatteNode* node, ComponentData* data, UpdateLane lane)
+    {
+        if (data->queued)
+        {
+            if (data->lane <= lane)
+                return;
+
+            // Already waiting in a lower priority lane, move it up
+            for (QueuedWork& queued : m_WorkQueues[data->lane])
+            {
+                if (queued.node == node)
+                {
+                    queued.node = nullptr;
+                    releaseWork(data->lane, queued.root, false);
+                }
+            }
+            m_WorkCount[data->lane]--;
+        }
+
+        data->queued = true;
+        data->lane = lane;
+        m_WorkCount[lane]++;
+
+        // One walk up for both the root and the depth
+        LatteNode* root = node;
+        uint32_t depth = 0;
+        while (root->parent != nullptr)
+        {
+            root = root->parent;
+            depth++;
+        }
+
+        m_LaneRoots[lane][root].queued++;
+
+        // Parents first, so a child that gets rebuilt as part of its parent isn't built twice.
+        // Work queued by a build is deeper than what is being built, so this is nearly always an append
+        std::deque<QueuedWork>& queue = m_WorkQueues[lane];
+        if (queue.empty() || queue.back().depth <= depth)
+        {
+            queue.push_back({ node, root, depth });
+            return;
+        }
+
+        auto position = std::upper_bound(queue.begin(), queue.end(), depth,
+            [](uint32_t value, const QueuedWork& queued) { return value < queued.depth; });
+        queue.insert(position, { node, root, depth });
+    }
+
+    void ComponentSystem::releaseWork(UpdateLane lane, LatteNode* root, bool built)
+    {
+        auto itr = m_LaneRoots[lane].find(root);
+        if (itr == m_LaneRoots[lane].end())
+            return;
+
+        LaneRoot& laneRoot = itr->second;
+        laneRoot.started |= built;
+        if (--laneRoot.queued == 0)
+            m_LaneRoots[lane].erase(itr);
+    }
+
+    void ComponentSystem::markDirty(LatteNode* node)
+    {
+        ComponentData* data = (ComponentData*)latteGetUserData(node);
+        if (data == nullptr || data->componentType == COMPONENT_TYPE_NONE || data->detached)
+            return;
+
+        data->needsRebuild = true;
+
+        enqueueWork(node, data, m_UpdateLane);
+
+        // Only the window this node lives in needs to do anything
+        std::shared_ptr<Window> win = EventLoop::getInstance().getWindowManager().getWindowForNode(node);
+        if (win)
+            EventLoop::getInstance().pushRebuild(win);
+    }
+
+    void ComponentSystem::queueRender(LatteNode* node)
+    {
+        ComponentData* data = (ComponentData*)latteGetUserData(node);
+        data->needsRebuild = true;
+
+        enqueueWork(node, data, m_WorkLane);
+    }
+
+    bool ComponentSystem::hasWork() const noexcept
+    {
+        for (size_t count : m_WorkCount)
+        {
+            if (count > 0)
+                return true;
+        }
+
+        return false;
+    }
+
+    std::pmr::unordered_set<LatteNode*> ComponentSystem::getBusyRoots() const
+    {
+        std::pmr::unordered_set<LatteNode*> roots(FrameArena::getInstance().getResource());
+        for (const auto& laneRoots : m_LaneRoots)
+        {
+            for (const auto& [root, laneRoot] : laneRoots)
+            {
+                if (laneRoot.started)
+                    roots.insert(root);
+            }
+        }
+
+        return roots;
+    }
+
+    static void rebuildComponent(LatteNode* node, ComponentData* data);
+
+    // The cheapest pipeline stages that cover what a build changed
+    static uint32_t invalidationForChanges(uint32_t changes)
+    {
+        if (changes & (NODE_CHANGE_LAYOUT | NODE_CHANGE_STRUCTURE))
+            return INVALIDATE_LAYOUT | INVALIDATE_PAINT;
+
+        if (changes & NODE_CHANGE_PAINT)
+            return INVALIDATE_PAINT;
+
+        return INVALIDATE_NONE;
+    }
+
+    bool ComponentSystem::performWork(uint64_t deadlineNs)
+    {
+        while (true)
+        {
+            // Take from the highest priority lane each time, building can queue more work
+            LatteNode* node = nullptr;
+            LatteNode* root = nullptr;
+            UpdateLane lane = UPDATE_LANE_INPUT;
+            for (int i = 0; i < UPDATE_LANE_COUNT && node == nullptr; i++)
+            {
+                auto& queue = m_WorkQueues[i];
+                while (!queue.empty() && node == nullptr)
+                {
+                    node = queue.front().node;
+                    root = queue.front().root;
+                    queue.pop_front();
+                }
+
+                lane = (UpdateLane)i;
+            }
+
+            if (node == nullptr)
+                break;
+
+            m_WorkCount[lane]--;
+
+            ComponentData* data = (ComponentData*)latteGetUserData(node);
+            data->queued = false;
+
+            // Could have already been rebuilt as part of a parent, or removed since it was queued
+            if (data->needsRebuild && !data->detached)
+            {
+                m_WorkLane = lane;
+                rebuildComponent(node, data);
+                m_WorkLane = UPDATE_LANE_INPUT;
+            }
+
+            // After the build, so the children it queued keep the tree marked as part way through
+            releaseWork(lane, root, true);
+
+            uint32_t changes = takeChanges();
+            if (changes != NODE_CHANGE_NONE)
+            {
+                std::shared_ptr<Window> win = EventLoop::getInstance().getWindowManager().getWindowForNode(node);
+                if (win)
+                    win->invalidate(invalidationForChanges(changes));
+            }
+
+            if (SDL_GetTicksNS() >= deadlineNs)
+                break;
+        }
+
+        return !hasWork();
+    }
+
+    static void markDetached(LatteNode* node)
+    {
+        if (ComponentData* data = (ComponentData*)latteGetUserData(node))
+            data->detached = true;
+
+        for (int i = 0; i < node->childCount; i++)
+            markDetached(node->children[i]);
+    }
+
+    void ComponentSystem::detachNode(LatteNode* node)
+    {
+        // Don't leave focus pointing at a node that is about to be freed
+        if (m_FocusedNode && isNodeInSubtree(m_FocusedNode, node))
+            setFocusedNode(nullptr);
+
+        latteOrphanNode(node);
+
+        // Only flags are set here, queued work and effects for the subtree are skipped and freed with it
+        markDetached(node);
+
+        m_DestroyQueue.push_back(node);
+    }
+
+    bool ComponentSystem::destroyDetached(uint64_t deadlineNs)
+    {
+        int freed = 0;
+        while (!m_DestroyQueue.empty())
+        {
+            LatteNode* root = m_DestroyQueue.back();
+
+            // Free a leaf at a time, always down the last child so removing it doesn't shift its siblings
+            LatteNode* node = root;
+            while (node->childCount > 0)
+                node = node->children[node->childCount - 1];
+
+            if (node == root)
+                m_DestroyQueue.pop_back();
+
+            recycleNode(node);
+
+            // Checking the clock for every node would cost more than small nodes take to free
+            if (++freed % 64 == 0 && SDL_GetTicksNS() >= deadlineNs)
+                break;
+        }
+
+        return m_DestroyQueue.empty();
+    }
+
+    static void resetComponentData(ComponentData* data)
+    {
+        // Containers are cleared rather than replaced so the next mount reuses their storage,
+        // every Lua reference is dropped so a pooled node doesn't keep anything alive
+        data->id = 0;
+        data->childIndex = 0;
+        data->key.clear();
+        data->type = WIDGET_TYPE_BOX;
+        data->style = STYLE_ID_DEFAULT;
+        data->state.reset();
+        data->stateReads.clear();
+        data->eventCallbacks.clear();
+        data->effectOffset = 0;
+        data->effects.clear();
+        data->memoOffset = 0;
+        data->memos.clear();
+        data->componentType = COMPONENT_TYPE_NONE;
+        data->props = sol::table();
+        data->fingerprint = 0;
+        data->staticSource = sol::table();
+        data->signals.clear();
+        data->list.reset();
+        data->itemBuilder = sol::nil;
+        data->providedContext = CONTEXT_NONE;
+        data->providedValue = sol::nil;
+        data->contextConsumers.clear();
+        data->contextProviders.clear();
+        data->needsRebuild = false;
+        data->detached = false;
+        data->queued = false;
+        data->lane = UPDATE_LANE_BACKGROUND;
+        data->text.clear();
+        data->fontSize = 0.0f;
+        memset(&data->internalState, 0, sizeof(ComponentState));
+    }
+
+    void ComponentSystem::recycleNode(LatteNode* node)
+    {
+        ComponentData* data = (ComponentData*)latteGetUserData(node);
+        if (data == nullptr || node->userDataDeleter != latteWidgetDataDeleter)
+        {
+            latteFreeNode(node);
+            return;
+        }
+
+        ComponentTypeId type = data->componentType;
+        if (type >= m_NodePool.size())
+            m_NodePool.resize(m_ComponentTypes.size());
+
+        std::vector<LatteNode*>& pool = m_NodePool[type];
+        if (pool.size() >= NODE_POOL_LIMIT)
+        {
+            latteFreeNode(node);
+            return;
+        }
+
+        latteOrphanNode(node);
+
+        // The same teardown the deleter does, only the memory is kept
+        onComponentDataDestroyed(data);
+        resetComponentData(data);
+        latteResetNode(node);
+
+        pool.push_back(node);
+    }
+
+    LatteNode* ComponentSystem::acquireNode(uint64_t id, ComponentTypeId type)
+    {
+        if (type < m_NodePool.size() && !m_NodePool[type].empty())
+        {
+            LatteNode* node = m_NodePool[type].back();
+            m_NodePool[type].pop_back();
+
+            ComponentData* data = (ComponentData*)latteGetUserData(node);
+            data->id = id;
+            return node;
+        }
+
+        // Identity lives in the component data so the layout node has no string id
+        LatteNode* node = latteCreateNode("", nullptr, LATTE_NODE_FLAGS_DELETE_USERDATA);
+        ComponentData* data = new ComponentData;
+        data->node = node;
+        data->id = id;
+        memset(&data->internalState, 0, sizeof(ComponentState));
+        latteUserData(node, data);
+        latteSetUserDataDeleter(node, latteWidgetDataDeleter);
+
+        return node;
+    }
+
+    static void clearStateReads(ComponentData* data)
+    {
+        for (const std::weak_ptr<State>& weak : data->stateReads)
+        {
+            if (std::shared_ptr<State> state = weak.lock())
+                state->removeReader(data);
+        }
+
+        data->stateReads.clear();
+    }
+
+    static void clearContextReads(ComponentData* data)
+    {
+        for (ComponentData* provider : data->contextProviders)
+            std::erase(provider->contextConsumers, data);
+
+        data->contextProviders.clear();
+    }
+
+    void ComponentSystem::onComponentDataDestroyed(ComponentData* data)
+    {
+        StylePool::getInstance().release(data->style);
+
+        // Lua can keep the state object alive, it must not point at a freed node
+        if (data->state)
+            data->state->detach();
+
+        clearStateReads(data);
+
+        if (data->staticSource.valid())
+            unfreezeTable(data->staticSource.pointer());
+
+        for (const std::shared_ptr<Signal>& signal : data->signals)
+            signal->unbind(data);
+
+        if (data->list)
+            data->list->unbind(data);
+
+        // Unlink from both sides so neither a provider nor a consumer is left pointing at freed data
+        for (ComponentData* consumer : data->contextConsumers)
+            std::erase(consumer->contextProviders, data);
+        clearContextReads(data);
+
+        if (data->queued)
+        {
+            for (QueuedWork& queued : m_WorkQueues[data->lane])
+            {
+                if (queued.node && queued.node->userPtr == data)
+                {
+                    queued.node = nullptr;
+                    releaseWork(data->lane, queued.root, false);
+                }
+            }
+            m_WorkCount[data->lane]--;
+        }
+
+        for (PendingEffect& pending : m_PendingEffects)
+        {
+            if (pending.data == data)
+                pending.data = nullptr;
+        }
+
+        // Unmounting, let effects undo whatever they set up
+        for (ComponentEffect& effect : data->effects)
+        {
+            if (!effect.cleanup.valid())
+                continue;
+
+            sol::protected_function_result result = effect.cleanup();
+            if (!result.valid())
+            {
+                sol::error err = result;
+                Log::log(Log::Severity::Error, "Effect cleanup failed: {}", err.what());
+            }
+        }
+    }
+
+    void ComponentSystem::provideContext(ComponentData* provider, ContextId context, sol::object value)
+    {
+        if (provider->providedContext == context && provider->providedValue == value)
+            return;
+
+        std::pmr::vector<ComponentData*> consumers(provider->contextConsumers.begin(), provider->contextConsumers.end(),
+            FrameArena::getInstance().getResource());
+
+        // A provider for a different context reusing the node, its consumers find their provider again when rebuilt
+        if (provider->providedContext != context)
+        {
+            for (ComponentData* consumer : consumers)
+                std::erase(consumer->contextProviders, provider);
+
+            provider->contextConsumers.clear();
+        }
+
+        provider->providedContext = context;
+        provider->providedValue = value;
+
+        // Only the components that read the context rebuild, not everything between them and the provider
+        for (ComponentData* consumer : consumers)
+            markDirty(consumer->node);
+    }
+
+    sol::object ComponentSystem::readContext(ComponentData* consumer, const Context& context)
+    {
+        for (LatteNode* node = consumer->node->parent; node != nullptr; node = node->parent)
+        {
+            ComponentData* data = (ComponentData*)latteGetUserData(node);
+            if (data == nullptr || data->providedContext != context.getId())
+                continue;
+
+            if (std::find(data->contextConsumers.begin(), data->contextConsumers.end(), consumer) == data->contextConsumers.end())
+            {
+                data->contextConsumers.push_back(consumer);
+                consumer->contextProviders.push_back(data);
+            }
+
+            return data->providedValue;
+        }
+
+        return context.getDefault();
+    }
+
+    static uint32_t setNodeText(LatteNode* node, ComponentData* data, std::string_view text);
+
+    void ComponentSystem::patchSignalField(ComponentData* data, SignalField field, const Signal& signal)
+    {
+        if (data->detached)
+            return;
+
+        uint32_t changes = NODE_CHANGE_NONE;
+
+        if (field == SIGNAL_FIELD_TEXT)
+        {
+            if (data->type == WIDGET_TYPE_TEXT)
+                changes = setNodeText(data->node, data, signal.getText());
+        }
+        else
+        {
+            ResolvedStyle style = StylePool::getInstance().get(data->style);
+
+            PackedColor color = 0;
+            bool valid = readColor(signal.get(), color);
+
+            switch (field)
+            {
+            case SIGNAL_FIELD_BACKGROUND_COLOR:
+                style.backgroundColor = valid ? color : 0;
+                style.flags = valid ? (style.flags | STYLE_FLAG_BACKGROUND) : (style.flags & ~STYLE_FLAG_BACKGROUND);
+                break;
+            case SIGNAL_FIELD_COLOR:
+                style.color = valid ? color : 0x000000FF;
+                style.flags = valid ? (style.flags | STYLE_FLAG_COLOR) : (style.flags & ~STYLE_FLAG_COLOR);
+                break;
+            case SIGNAL_FIELD_BORDER_COLOR:
+                style.borderColor = valid ? color : 0;
+                style.flags = valid ? (style.flags | STYLE_FLAG_BORDER_COLOR) : (style.flags & ~STYLE_FLAG_BORDER_COLOR);
+                break;
+            default:
+                break;
+            }
+
+            StyleId id = StylePool::getInstance().acquire(style);
+            StylePool::getInstance().release(data->style);
+
+            if (id != data->style)
+                changes = NODE_CHANGE_PAINT;
+
+            data->style = id;
+        }
+
+        if (changes == NODE_CHANGE_NONE)
+            return;
+
+        std::shared_ptr<Window> win = EventLoop::getInstance().getWindowManager().getWindowForNode(data->node);
+        if (!win)
+            return;
+
+        if (changes & NODE_CHANGE_LAYOUT)
+            EventLoop::getInstance().pushRelayout(win);
+        else
+            EventLoop::getInstance().pushRepaint(win);
+    }
+
+    void ComponentSystem::freezeTable(const sol::table& table, uint64_t fingerprint, uint64_t keyHash, bool keyed)
+    {
+        FrozenTable& frozen = m_FrozenTables[table.pointer()];
+        frozen.fingerprint = fingerprint;
+        frozen.keyHash = keyHash;
+        frozen.keyed = keyed;
+        frozen.refs++;
+    }
+
+    void ComponentSystem::unfreezeTable(const void* table)
+    {
+        auto itr = m_FrozenTables.find(table);
+        if (itr == m_FrozenTables.end())
+            return;
+
+        if (--itr->second.refs <= 0)
+            m_FrozenTables.erase(itr);
+    }
+
+    void ComponentSystem::queueEffect(ComponentData* data, int index)
+    {
+        ComponentEffect& effect = data->effects[index];
+        if (effect.queued)
+            return;
+
+        effect.queued = true;
+        m_PendingEffects.push_back({ data, index });
+    }
+
+    void ComponentSystem::flushEffects(const std::pmr::unordered_set<LatteNode*>* heldRoots)
+    {
+        // Effects can set state and queue more, those wait for the commit they cause.
+        // Indexed as an effect can free nodes, which nulls their entries
+        const size_t count = m_PendingEffects.size();
+        size_t kept = 0;
+        for (size_t i = 0; i < count; i++)
+        {
+            PendingEffect entry = m_PendingEffects[i];
+            if (entry.data == nullptr || entry.data->detached)
+                continue;
+
+            // That tree hasn't been presented yet, keep its effects at the front for a later flush
+            if (heldRoots && heldRoots->contains(getRootNode(entry.data->node)))
+            {
+                m_PendingEffects[kept++] = entry;
+                continue;
+            }
+
+            ComponentEffect& effect = entry.data->effects[entry.index];
+            effect.queued = false;
+
+            if (effect.cleanup.valid())
+            {
+                sol::protected_function cleanup = effect.cleanup;
+                effect.cleanup = sol::nil;
+
+                sol::protected_function_result result = cleanup();
+                if (!result.valid())
+                {
+                    sol::error err = result;
+                    Log::log(Log::Severity::Error, "Effect cleanup failed: {}", err.what());
+                }
+
+                if (m_PendingEffects[i].data == nullptr)
+                    continue;
+            }
+
+            sol::protected_function_result result = effect.func();
+            if (!result.valid())
+            {
+                sol::error err = result;
+                Log::log(Log::Severity::Error, "Effect failed: {}", err.what());
+                continue;
+            }
+
+            if (result.return_count() > 0 && result.get_type() == sol::type::function)
+                effect.cleanup = result.get<sol::protected_function>();
+        }
+
+        m_PendingEffects.erase(m_PendingEffects.begin() + kept, m_PendingEffects.begin() + count);
+    }
+
     // Child processing functions
-    static void processChildrenFromTable(LatteNode* node, sol::table childrenTable);
-    static LatteNode* findOrCreateChildNode(LatteNode* parent, const std::string& id);
-    static void processComponentChild(LatteNode* node, sol::table componentTable);
-    static void processRegularChild(LatteNode* node, sol::object childData);
+    static void processChildren(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode);
+    static LatteNode* findOrCreateChildNode(LatteNode* parent, uint64_t id, ComponentTypeId type);
+    static LatteNode* createChildNode(uint64_t id, ComponentTypeId type);
+    static void removeChildRange(LatteNode* parent, int index, int count);
+    static void processChild(LatteNode* childNode, const VNodeBuffer& buffer, const VNode& child);
+    static void applyListBinding(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
+    static void buildListItem(LatteNode* host, ComponentData* hostData, uint32_t index, bool insert);
+    static void processComponentChild(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode);
+    static void applyComponentRoot(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode, bool applyForThis);
+    static void processElementChild(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
+    static void applyVNode(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode, bool applyForThis);
 
     // Property application functions
-    static void applyNodeProperties(LatteNode* node, sol::table table);
-    static void applyEventHandlers(ComponentData* data, sol::table table);
-    static void applyStyle(ComponentData* data, sol::table table);
-    static void applyLayoutProperties(LatteNode* node, ComponentData* data, sol::table table);
+    static void applyNodeProperties(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode);
+    static void applyEventHandlers(ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
+    static void applySignals(ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
+    static void applyStyle(ComponentData* data, const VNode& vnode);
+    static void applyLayoutProperties(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
 
     // Widget-specific property functions
-    static void applyBoxProperties(LatteNode* node, sol::table table);
-    static void applyTextProperties(LatteNode* node, ComponentData* data, sol::table table);
+    static void applyBoxProperties(LatteNode* node, const VNode& vnode);
+    static void applyTextProperties(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode);
 
     // Helper functions
-    static std::string generateChildId(const std::string& parentId, int childIndex, sol::table table = sol::nil);
+    static uint64_t generateChildId(uint64_t parentId, const VNode& vnode);
 
-    static void processChildrenFromTable(LatteNode* node, sol::table childrenTable)
+    static void processChildren(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode)
     {
-        std::set<std::string> childrenToKeep;
-        std::set<std::string> newIds;
+        const uint64_t parentId = getNodeId(node);
+
+        // Scratch containers only live for this call so they come from the frame arena
+        std::pmr::memory_resource* arena = FrameArena::getInstance().getResource();
 
-        // Collect all new child IDs
-        for (auto& child : childrenTable)
+        // Collect all new child IDs, kept in buffer order for the build pass below
+        std::pmr::vector<uint64_t> childIds(vnode.childCount, arena);
+        std::pmr::unordered_set<uint64_t> newIds(arena);
+        newIds.reserve(vnode.childCount);
+        for (uint32_t i = 0; i < vnode.childCount; i++)
         {
-            std::string childId = generateChildId(node->id, child.first.as<int>(), child.second.as<sol::table>());
-            newIds.insert(childId);
+            childIds[i] = generateChildId(parentId, buffer.get(vnode.firstChild + i));
+            newIds.insert(childIds[i]);
         }
 
         // Identify and remove obsolete children BEFORE building new ones
-        std::vector<LatteNode*> toRemove;
+        std::pmr::vector<LatteNode*> toRemove(arena);
         for (int i = 0; i < node->childCount; ++i)
         {
-            if (newIds.find(node->children[i]->id) == newIds.end())
+            if (newIds.find(getNodeId(node->children[i])) == newIds.end())
             {
                 toRemove.push_back(node->children[i]);
             }
         }
         // Actually remove them
         for (LatteNode* doomed : toRemove)
-        {
-            Log::log(Log::Severity::Info, "Remove node: {}", doomed->id);
-            latteFreeNode(doomed);
-        }
+            ComponentSystem::getInstance().detachNode(doomed);
+
+        if (!toRemove.empty())
+            ComponentSystem::getInstance().recordChange(NODE_CHANGE_STRUCTURE);
 
         // Now process the new layout
-        for (auto& child : childrenTable)
+        for (uint32_t i = 0; i < vnode.childCount; i++)
         {
-            std::string childId = generateChildId(node->id, child.first.as<int>(), child.second.as<sol::table>());
-            ComponentSystem::getInstance().pushID(childId);
-            childrenToKeep.insert(childId);
+            const VNode& child = buffer.get(vnode.firstChild + i);
+            LatteNode* childNode = findOrCreateChildNode(node, childIds[i], child.componentType);
+            processChild(childNode, buffer, child);
+        }
+    }
+
+    static void processChild(LatteNode* childNode, const VNodeBuffer& buffer, const VNode& child)
+    {
+        ComponentSystem::getInstance().pushNode(childNode);
 
-            LatteNode* childNode = findOrCreateChildNode(node, childId);
-            ((ComponentData*)latteGetUserData(childNode))->effectOffset = 0;
+        ComponentData* childData = (ComponentData*)latteGetUserData(childNode);
+        childData->effectOffset = 0;
+        childData->memoOffset = 0;
 
-            if (child.second.as<sol::table>()["component_type"].valid())
-                processComponentChild(childNode, child.second.as<sol::table>());
-            else
-                processRegularChild(childNode, child.second);
+        // Keyed children can move, the rest are already identified by their index
+        childData->childIndex = child.childIndex;
+        if (childData->key.empty() && (child.flags & VNODE_FLAG_KEYED))
+            childData->key = buffer.getKey(child);
 
-            ComponentSystem::getInstance().popID();
+        if (child.kind == VNODE_COMPONENT)
+            processComponentChild(childNode, buffer, child);
+        else
+        {
+            childData->type = latte::WIDGET_TYPE_BOX;
+            processElementChild(childNode, childData, buffer, child);
         }
+
+        ComponentSystem::getInstance().popNode();
     }
 
-    static LatteNode* findOrCreateChildNode(LatteNode* parent, const std::string& id)
+    static LatteNode* findOrCreateChildNode(LatteNode* parent, uint64_t id, ComponentTypeId type)
     {
         // Try to find existing child
         for (int i = 0; i < parent->childCount; i++)
         {
-            if (parent->children[i]->id == id)
+            if (getNodeId(parent->children[i]) == id)
                 return parent->children[i];
         }
 
-        // Create new child
-        LatteNode* childNode = latteCreateNode(id.c_str(), parent, LATTE_NODE_FLAGS_DELETE_USERDATA);
-        ComponentData* data = new ComponentData;
-        memset(&data->internalState, 0, sizeof(ComponentState));
-        latteUserData(childNode, data);
-        latteSetUserDataDeleter(childNode, latteWidgetDataDeleter);
+        LatteNode* childNode = createChildNode(id, type);
+        latteNodeAddChild(parent, childNode);
+
+        return childNode;
+    }
+
+    static LatteNode* createChildNode(uint64_t id, ComponentTypeId type)
+    {
+        // Created detached so the caller decides where it goes
+        LatteNode* childNode = ComponentSystem::getInstance().acquireNode(id, type);
+
+        ComponentSystem::getInstance().recordChange(NODE_CHANGE_STRUCTURE);
 
         return childNode;
     }
 
-    static void processComponentChild(LatteNode* node, sol::table componentTable)
+    static void removeChildRange(LatteNode* parent, int index, int count)
+    {
+        // Orphaned together so removing a range doesn't search and shift the children once per node
+        std::pmr::vector<LatteNode*> doomed(count, FrameArena::getInstance().getResource());
+        latteOrphanChildren(parent, index, count, doomed.data());
+
+        for (LatteNode* node : doomed)
+            ComponentSystem::getInstance().detachNode(node);
+
+        ComponentSystem::getInstance().recordChange(NODE_CHANGE_STRUCTURE);
+    }
+
+    static void applyListBinding(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
+    {
+        const VNodeList* list = (vnode.flags & VNODE_FLAG_LIST) ? &buffer.getList(vnode) : nullptr;
+
+        // Same list as last time, its changes have already been applied so only the builder can be new.
+        // Existing items aren't rebuilt with it, the builder is usually a new closure every build
+        // and rebuilding every item each time would undo the point of the list
+        if (list && data->list == list->items)
+        {
+            data->itemBuilder = list->itemBuilder;
+            return;
+        }
+
+        // The old list's children go with it, as does anything that was there before a list was bound
+        if (data->list)
+        {
+            data->list->unbind(data);
+            data->list.reset();
+            data->itemBuilder = sol::nil;
+        }
+
+        if (node->childCount > 0 && (list || !(vnode.flags & VNODE_FLAG_CHILDREN)))
+            removeChildRange(node, 0, node->childCount);
+
+        if (list == nullptr)
+            return;
+
+        data->list = list->items;
+        data->itemBuilder = list->itemBuilder;
+        data->list->bind(data);
+
+        for (uint32_t i = 0; i < data->list->size(); i++)
+            buildListItem(node, data, i, true);
+    }
+
+    static void buildListItem(LatteNode* host, ComponentData* hostData, uint32_t index, bool insert)
+    {
+        const ObservableList& list = *hostData->list;
+
+        // Identified by the item, not its position, so moves and inserts above it keep its node
+        uint64_t id = hashCombine(hostData->id, list.getItemId(index));
+
+        sol::table item;
+        sol::protected_function_result result = hostData->itemBuilder(list.getValue(index), index + 1);
+        if (!result.valid())
+        {
+            sol::error err = result;
+            Log::log(Log::Severity::Error, "itemBuilder failed: {}", err.what());
+        }
+        else if (result.get_type() == sol::type::table)
+            item = result.get<sol::table>();
+        else
+            Log::log(Log::Severity::Warning, "itemBuilder must return a table, item {} is left empty", index + 1);
+
+        // Converted before the node is created so it can come from the pool for the item's component type
+        VNodeBuffer buffer;
+        const VNode* vnode = item.valid() ? &buffer.get(buffer.build(item)) : nullptr;
+        ComponentTypeId type = vnode ? vnode->componentType : COMPONENT_TYPE_NONE;
+
+        LatteNode* itemNode = nullptr;
+        if (insert)
+        {
+            itemNode = createChildNode(id, type);
+            latteNodeInsertChild(host, itemNode, (int)index);
+        }
+        else
+            itemNode = host->children[index];
+
+        // An empty node keeps the children lined up with the list
+        if (vnode == nullptr)
+            return;
+
+        // Built as a different component than before, the old one's state doesn't carry over
+        ComponentData* itemData = (ComponentData*)latteGetUserData(itemNode);
+        if (!insert && itemData->componentType != type)
+        {
+            removeChildRange(host, (int)index, 1);
+            itemNode = createChildNode(id, type);
+            latteNodeInsertChild(host, itemNode, (int)index);
+        }
+
+        processChild(itemNode, buffer, *vnode);
+
+        ((ComponentData*)latteGetUserData(itemNode))->childIndex = (int)index;
+    }
+
+    // Items after an edit have shifted, their childIndex has to follow or paths and ids name the wrong item
+    static void renumberListItems(LatteNode* host, int from)
+    {
+        for (int i = from; i < host->childCount; i++)
+        {
+            if (ComponentData* data = (ComponentData*)latteGetUserData(host->children[i]))
+                data->childIndex = i;
+        }
+    }
+
+    void ComponentSystem::applyListChange(ComponentData* host, const ListChange& change)
+    {
+        if (host->detached)
+            return;
+
+        LatteNode* node = host->node;
+
+        // What changes here belongs to the list, not to whatever unit of work might be being built
+        uint32_t outer = takeChanges();
+
+        switch (change.type)
+        {
+        case LIST_CHANGE_INSERT:
+            for (uint32_t i = 0; i < change.count; i++)
+                buildListItem(node, host, change.index + i, true);
+            renumberListItems(node, (int)(change.index + change.count));
+            break;
+        case LIST_CHANGE_REMOVE:
+            removeChildRange(node, (int)change.index, (int)change.count);
+            renumberListItems(node, (int)change.index);
+            break;
+        case LIST_CHANGE_MOVE:
+            latteNodeMoveChild(node, (int)change.index, (int)change.to);
+            renumberListItems(node, (int)std::min(change.index, change.to));
+            recordChange(NODE_CHANGE_LAYOUT);
+            break;
+        case LIST_CHANGE_UPDATE:
+            for (uint32_t i = 0; i < change.count; i++)
+                buildListItem(node, host, change.index + i, false);
+            break;
+        }
+
+        uint32_t changes = takeChanges();
+        m_Changes = outer;
+
+        std::shared_ptr<Window> win = EventLoop::getInstance().getWindowManager().getWindowForNode(node);
+        if (!win)
+            return;
+
+        if (changes & (NODE_CHANGE_LAYOUT | NODE_CHANGE_STRUCTURE))
+            EventLoop::getInstance().pushRelayout(win);
+        else if (changes & NODE_CHANGE_PAINT)
+            EventLoop::getInstance().pushRepaint(win);
+
+        // Component items were queued, they are built by the next commit
+        if (hasWork())
+            EventLoop::getInstance().pushRebuild(win);
+    }
+
+    static void processComponentChild(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode)
+    {
+        ComponentData* data = (ComponentData*)latteGetUserData(node);
+
+        const ComponentType* type = ComponentSystem::getInstance().getComponentType(vnode.componentType);
+        if (type == nullptr)
+        {
+            Log::log(Log::Severity::Error, "No component found for type id {}", vnode.componentType);
+            return;
+        }
+
+        data->type = type->widgetType;
+
+        const sol::table& props = buffer.getProps(vnode);
+
+        // Memoized components keep their last build if the props are shallow equal
+        // and nothing inside them has changed state
+        bool memo = (vnode.flags & VNODE_FLAG_MEMO) != 0;
+        if (memo && !data->needsRebuild && data->props.valid() && shallowTableEqual(data->props, props))
+            return;
+
+        data->componentType = vnode.componentType;
+        data->props = props;
+
+        // Built later as its own unit of work so a big rebuild can yield between components
+        ComponentSystem::getInstance().queueRender(node);
+    }
+
+    static void processElementChild(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
+    {
+        if (vnode.flags & VNODE_FLAG_FROZEN)
+        {
+            // Same frozen table as last time, nothing to do
+            if (data->fingerprint == vnode.fingerprint)
+                return;
+
+            // A frozen table mounted somewhere new, it was never converted so do that now
+            VNodeBuffer frozenBuffer;
+            const VNode& full = frozenBuffer.get(frozenBuffer.build(buffer.getSource(vnode)));
+
+            if (data->key.empty() && (full.flags & VNODE_FLAG_KEYED))
+                data->key = frozenBuffer.getKey(full);
+
+            processElementChild(node, data, frozenBuffer, full);
+            return;
+        }
+
+        applyVNode(node, buffer, vnode, true);
+
+        // Freeze static tables so the next build doesn't even read them
+        const void* previous = data->staticSource.valid() ? data->staticSource.pointer() : nullptr;
+        if (vnode.flags & VNODE_FLAG_STATIC)
+        {
+            const sol::table& source = buffer.getSource(vnode);
+            if (source.pointer() != previous)
+            {
+                ComponentSystem::getInstance().freezeTable(source, vnode.fingerprint, vnode.keyHash, (vnode.flags & VNODE_FLAG_KEYED) != 0);
+                if (previous)
+                    ComponentSystem::getInstance().unfreezeTable(previous);
+
+                data->staticSource = source;
+            }
+        }
+        else if (previous)
+        {
+            ComponentSystem::getInstance().unfreezeTable(previous);
+            data->staticSource = sol::table();
+        }
+    }
+
+    static void renderComponent(LatteNode* node, ComponentData* data)
     {
-        ((ComponentData*)latteGetUserData(node))->type = latte::WIDGET_TYPE_BOX;
+        data->needsRebuild = false;
 
-        std::string componentType = componentTable["component_type"];
+        if (data->state)
+            data->state->beginRender();
 
-        // TODO: Need a better way to handle this
-        if (componentType == "ui.Text")
-            ((ComponentData*)latteGetUserData(node))->type = latte::WIDGET_TYPE_TEXT;
+        // Reads of other components' state and of contexts are recorded again by this build,
+        // so a provider it no longer reads won't rebuild it
+        clearStateReads(data);
+        clearContextReads(data);
 
-        sol::protected_function ctor = ComponentSystem::getInstance().getComponent(componentType);
-        if (!ctor.valid()) 
+        const ComponentType* type = ComponentSystem::getInstance().getComponentType(data->componentType);
+        if (type == nullptr || !type->ctor.valid()) 
         {
-            Log::log(Log::Severity::Error, "No component found for type '{}'", componentType);
+            Log::log(Log::Severity::Error, "No component found for type id {}", data->componentType);
             return; 
         }
 
-        sol::protected_function_result result = ctor(componentTable["original_props"]);
+        sol::protected_function_result result = type->ctor(data->props);
         if (!result.valid()) 
         {
             sol::error err = result;
-            Log::log(Log::Severity::Error, "Component {} failed: {}", componentType, err.what());
+            Log::log(Log::Severity::Error, "Component {} failed: {}", type->name, err.what());
             return;
         }
 
@@ -174,164 +1130,290 @@ namespace latte
         applyPropsFromTable(node, ret);
     }
 
-    static void processRegularChild(LatteNode* node, sol::object childData)
+    static void rebuildComponent(LatteNode* node, ComponentData* data)
     {
-        ((ComponentData*)latteGetUserData(node))->type = latte::WIDGET_TYPE_BOX;
-        applyPropsFromTable(node, childData);
+        ComponentSystem::getInstance().pushNode(node);
+
+        data->effectOffset = 0;
+        data->memoOffset = 0;
+        renderComponent(node, data);
+
+        ComponentSystem::getInstance().popNode();
+    }
+
+    static void applyComponentRoot(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode, bool applyForThis)
+    {
+        const ComponentType* type = ComponentSystem::getInstance().getComponentType(vnode.componentType);
+        if (type == nullptr || !type->ctor.valid())
+        {
+            Log::log(Log::Severity::Error, "No component found for type id {}", vnode.componentType);
+            return;
+        }
+
+        // The innermost component decides what kind of widget this node is
+        if (ComponentData* data = applyForThis ? (ComponentData*)latteGetUserData(node) : nullptr)
+            data->type = type->widgetType;
+
+        // Built inline on the same node, its hooks belong to the component being rendered
+        sol::protected_function_result result = type->ctor(buffer.getProps(vnode));
+        if (!result.valid())
+        {
+            sol::error err = result;
+            Log::log(Log::Severity::Error, "Component {} failed: {}", type->name, err.what());
+            return;
+        }
+
+        sol::table ret = result;
+        applyPropsFromTable(node, ret, applyForThis);
+    }
+
+    static void applyVNode(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode, bool applyForThis)
+    {
+        // A component that returns another component renders what that one returns
+        if (vnode.kind == VNODE_COMPONENT)
+        {
+            applyComponentRoot(node, buffer, vnode, applyForThis);
+            return;
+        }
+
+        ComponentData* data = applyForThis ? (ComponentData*)latteGetUserData(node) : nullptr;
+
+        // Nothing the reconciler reads has changed since this was last applied, skip the whole subtree
+        if (data && vnode.fingerprint != 0 && data->fingerprint == vnode.fingerprint)
+            return;
+
+        if (data && ((vnode.flags & VNODE_FLAG_LIST) || data->list))
+            applyListBinding(node, data, buffer, vnode);
+
+        if (vnode.flags & VNODE_FLAG_CHILDREN)
+        {
+            processChildren(node, buffer, vnode);
+        }
+
+        if (applyForThis)
+        {
+            applyNodeProperties(node, buffer, vnode);
+        }
+
+        if (data)
+            data->fingerprint = vnode.fingerprint;
     }
 
-    static void applyNodeProperties(LatteNode* node, sol::table table)
+    static void applyNodeProperties(LatteNode* node, const VNodeBuffer& buffer, const VNode& vnode)
     {
         ComponentData* data = (ComponentData*)latteGetUserData(node);
         if (!data) return;
 
-        applyEventHandlers(data, table);
-        applyStyle(data, table);
-        applyLayoutProperties(node, data, table);
+        applyEventHandlers(data, buffer, vnode);
+        applySignals(data, buffer, vnode);
+        applyStyle(data, vnode);
+        applyLayoutProperties(node, data, buffer, vnode);
     }
 
-    static void applyEventHandlers(ComponentData* data, sol::table table)
+    static void applyEventHandlers(ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
     {
-        auto getEventHandler = [&](const std::string& luaName, ComponentEvent evnt)
-            {
-                sol::object obj = table[luaName];
-                if (obj.valid() && obj.get_type() == sol::type::function)
-                    data->eventCallbacks[evnt] = obj.as<sol::protected_function>();
-            };
+        const VNodeHandler* handlers = buffer.getHandlers(vnode);
+        for (uint32_t i = 0; i < vnode.handlerCount; i++)
+            data->eventCallbacks[handlers[i].event] = handlers[i].func;
+    }
+
+    static void applySignals(ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
+    {
+        if (data->signals.empty() && vnode.signalCount == 0)
+            return;
+
+        for (const std::shared_ptr<Signal>& signal : data->signals)
+            signal->unbind(data);
+        data->signals.clear();
 
-        getEventHandler("onPaint", COMPONENT_EVENT_PAINT);
-        getEventHandler("onHoverEnter", COMPONENT_EVENT_HOVER_ENTER);
-        getEventHandler("onHoverExit", COMPONENT_EVENT_HOVER_EXIT);
-        getEventHandler("onClick", COMPONENT_EVENT_CLICK);
-        getEventHandler("onKeyDown", COMPONENT_EVENT_KEY_DOWN);
-        getEventHandler("onTextInput", COMPONENT_EVENT_TEXT_INPUT);
+        const VNodeSignal* signals = buffer.getSignals(vnode);
+        for (uint32_t i = 0; i < vnode.signalCount; i++)
+        {
+            signals[i].signal->bind(data, signals[i].field);
+            data->signals.push_back(signals[i].signal);
+        }
     }
 
-    static void applyStyle(ComponentData* data, sol::table table)
+    static void applyStyle(ComponentData* data, const VNode& vnode)
     {
-        sol::object style = table["style"];
-        if (style.valid() && style.get_type() == sol::type::table)
-            data->style = sol::table(style.as<sol::table>());
+        if (vnode.flags & VNODE_FLAG_STYLE)
+        {
+            // Acquire before releasing so an unchanged style keeps its entry alive
+            StyleId id = StylePool::getInstance().acquire(vnode.style);
+            StylePool::getInstance().release(data->style);
+
+            // Interned, so the same id means nothing visible changed
+            if (id != data->style)
+                ComponentSystem::getInstance().recordChange(NODE_CHANGE_PAINT);
+
+            data->style = id;
+        }
     }
 
-    static void applyLayoutProperties(LatteNode* node, ComponentData* data, sol::table table)
+    static void applyLayoutProperties(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
     {
         if (data->type == latte::WIDGET_TYPE_BOX)
         {
-            applyBoxProperties(node, table);
+            applyBoxProperties(node, vnode);
         }
         else if (data->type == latte::WIDGET_TYPE_TEXT)
         {
-            applyTextProperties(node, data, table);
+            applyTextProperties(node, data, buffer, vnode);
         }
 
         // Handle getting the positioner stuff
         // Layout like this is the same for text and box model stuff
-        int positioner = table.get_or("layout", 0);
-        if (positioner == LATTE_POSITIONER_ABSOLUTE)
+        if (vnode.flags & VNODE_FLAG_ABSOLUTE)
         {
-            float reqx = 0.0f, reqy = 0.0f;
+            float reqx = vnode.position[0];
+            float reqy = vnode.position[1];
 
-            sol::object positionTable = table["position"];
-            if (positionTable.get_type() == sol::type::table)
+            if (node->positioner.type != LATTE_POSITIONER_ABSOLUTE || 
+                node->positioner.position.x != reqx || node->positioner.position.y != reqy)
             {
-                sol::table t = positionTable.as<sol::table>();
-                reqx = t.get_or(1, 0.0f);
-                reqy = t.get_or(2, 0.0f);
+                latteAbsolutePositioner(node, reqx, reqy);
+                ComponentSystem::getInstance().recordChange(NODE_CHANGE_LAYOUT);
             }
-
-            latteAbsolutePositioner(node, reqx, reqy);
         }
     }
 
-    static void applyBoxProperties(LatteNode* node, sol::table table)
+    static void applyBoxProperties(LatteNode* node, const VNode& vnode)
     {
-        if (table["padding"].valid() && table["padding"].get_type() == sol::type::table)
+        // Every latte setter dirties the subtree, so only call them when a value differs
+        bool changed = false;
+
+        if (vnode.flags & VNODE_FLAG_PADDING)
         {
-            sol::table paddingTable = table["padding"];
-            float l = paddingTable.get<float>(1);
-            float t = paddingTable.get<float>(2);
-            float r = paddingTable.get<float>(3);
-            float b = paddingTable.get<float>(4);
-            lattePaddingRLTB(node, r, l, t, b);
+            float l = vnode.padding[0];
+            float t = vnode.padding[1];
+            float r = vnode.padding[2];
+            float b = vnode.padding[3];
+
+            const LatteMargin& padding = node->padding;
+            if (padding.left != l || padding.top != t || padding.right != r || padding.bottom != b)
+            {
+                lattePaddingRLTB(node, r, l, t, b);
+                changed = true;
+            }
         }
 
-        if (table["size"].valid() && table["size"].get_type() == sol::type::table)
+        if (vnode.flags & VNODE_FLAG_SIZE)
         {
-            sol::table sizeTable = table["size"];
-            float w = sizeTable.get<float>(1);
-            float h = sizeTable.get<float>(2);
-            latteSizer(node, w, h);
+            float w = vnode.size[0];
+            float h = vnode.size[1];
+
+            if (node->sizer.widthSizer != w || node->sizer.heightSizer != h)
+            {
+                latteSizer(node, w, h);
+                changed = true;
+            }
         }
 
-        latteSpacing(node, table.get_or("spacing", 0.0f));
-        latteMainAxisAlignment(node, (LatteContentAlignment)table.get_or("mainAxisAlignment", (int)LATTE_CONTENT_START));
-        latteCrossAxisAlignment(node, (LatteContentAlignment)table.get_or("crossAxisAlignment", (int)LATTE_CONTENT_START));
+        if (node->spacing != vnode.spacing)
+        {
+            latteSpacing(node, vnode.spacing);
+            changed = true;
+        }
 
-        std::string dir = table.get_or("direction", std::string("horizontal"));
-        if (dir == "horizontal")
-            latteMainAxisDirection(node, LATTE_DIRECTION_HORIZONTAL);
-        else if (dir == "vertical")
-            latteMainAxisDirection(node, LATTE_DIRECTION_VERTICAL);
-    }
+        if (node->mainAxisAlignment != vnode.mainAxisAlignment)
+        {
+            latteMainAxisAlignment(node, vnode.mainAxisAlignment);
+            changed = true;
+        }
 
-    static void applyTextProperties(LatteNode* node, ComponentData* data, sol::table table)
-    {
-        std::string text = table["text"].get<std::string>();
+        if (node->crossAxisAlignment != vnode.crossAxisAlignment)
+        {
+            latteCrossAxisAlignment(node, vnode.crossAxisAlignment);
+            changed = true;
+        }
 
-        float fontSize = 14.0f;
-        if (data->style.valid())
+        // Leaving direction out means the default, not whatever the last build set
+        LatteLayoutDirection direction = (vnode.flags & VNODE_FLAG_DIRECTION) ? vnode.direction : LATTE_DIRECTION_HORIZONTAL;
+        if (node->layoutDirection != direction)
         {
-            fontSize = data->style.get_or("fontSize", 14.0f);
+            latteMainAxisDirection(node, direction);
+            changed = true;
         }
 
+        if (changed)
+            ComponentSystem::getInstance().recordChange(NODE_CHANGE_LAYOUT);
+    }
+
+    static void applyTextProperties(LatteNode* node, ComponentData* data, const VNodeBuffer& buffer, const VNode& vnode)
+    {
+        ComponentSystem::getInstance().recordChange(setNodeText(node, data, buffer.getText(vnode)));
+    }
+
+    // Sets and measures a text widget's text, returns what changed as NodeChange flags
+    static uint32_t setNodeText(LatteNode* node, ComponentData* data, std::string_view text)
+    {
+        uint32_t changes = NODE_CHANGE_NONE;
+
         // TODO: Make this a function in render interface to remove nanovg from this
-        nvgFontFace(RenderInterface::getInstance().getNVGContext(), "Roboto-Regular");
-        nvgFontSize(RenderInterface::getInstance().getNVGContext(), fontSize);
+        NVGcontext* vg = RenderInterface::getInstance().getNVGContext();
+        const ResolvedStyle& style = StylePool::getInstance().get(data->style);
+        if (style.fontHandle >= 0)
+            nvgFontFaceId(vg, style.fontHandle);
+        else
+            nvgFontFace(vg, "Roboto-Regular");
+        nvgFontSize(vg, style.fontSize);
 
         float bounds[4];
-        float w = nvgTextBounds(RenderInterface::getInstance().getNVGContext(), 0.0f, 0.0f, text.c_str(), NULL, bounds);
+        float w = nvgTextBounds(vg, 0.0f, 0.0f, text.data(), text.data() + text.size(), bounds);
         float h = bounds[3] - bounds[1];
 
-        data->text = text;
-        latteSizer(node, w, h);
+        // New text that measures the same only needs a repaint
+        if (data->text != text)
+        {
+            data->text = text;
+            changes |= NODE_CHANGE_PAINT;
+        }
+
+        if (node->sizer.widthSizer != w || node->sizer.heightSizer != h)
+        {
+            latteSizer(node, w, h);
+            changes |= NODE_CHANGE_LAYOUT;
+        }
+
+        return changes;
     }
 
-    static std::string generateChildId(const std::string& parentId, int childIndex, sol::table table)
+    static uint64_t generateChildId(uint64_t parentId, const VNode& vnode)
     {
-        // Early out if valid string id
-        if (table != sol::nil) 
+        // Early out if keyed
+        if (vnode.flags & VNODE_FLAG_KEYED) 
         {
-            sol::object idObj = table["id"];
-            if (idObj.is<std::string>()) 
-            {
-                return parentId + "/" + idObj.as<std::string>();
-            }
+            return hashCombine(parentId, vnode.keyHash);
+        }
 
-            sol::object compTypeObj = table["component_type"];
-            if (compTypeObj.is<std::string>()) 
-            {
-                return parentId + "/" + std::to_string(childIndex) +
-                    "." + compTypeObj.as<std::string>();
-            }
+        if (const ComponentType* type = ComponentSystem::getInstance().getComponentType(vnode.componentType)) 
+        {
+            return hashCombine(hashCombine(parentId, (uint64_t)vnode.childIndex), type->nameHash);
         }
-        // Fallback if no component_type found or table is nil
-        return parentId + "/" + std::to_string(childIndex);
+
+        // Fallback for regular nodes
+        return hashCombine(parentId, (uint64_t)vnode.childIndex);
     }
 
     void applyPropsFromTable(LatteNode* node, sol::table table, bool applyForThis)
     {
+        // Child components are deferred, only a component root built inline nests and gets a fresh buffer
+        static VNodeBuffer s_Buffer;
+        static bool s_BufferInUse = false;
 
-        // Log::log(Log::Severity::Info, "Rebuilding Node: {}", node->id);
+        VNodeBuffer localBuffer;
+        VNodeBuffer& buffer = s_BufferInUse ? localBuffer : s_Buffer;
+        bool ownsShared = !s_BufferInUse;
+        s_BufferInUse = true;
 
-        if (table["children"].valid() && table["children"].get_type() == sol::type::table)
-        {
-            processChildrenFromTable(node, table["children"]);
-        }
+        // Log::log(Log::Severity::Info, "Rebuilding Node: {}", describeNode(node));
 
-        if (applyForThis)
-        {
-            applyNodeProperties(node, table);
-        }
+        // Read the whole output out of Lua once, everything after this works on the buffer
+        uint32_t root = buffer.build(table);
+        applyVNode(node, buffer, buffer.get(root), applyForThis);
+
+        buffer.clear();
+        if (ownsShared)
+            s_BufferInUse = false;
     }
-}
\ No newline at end of file
+}
@@ -8,9 +8,19 @@ extern "C" {
 }
 #include "../Utils/Singleton.h"
 #include <unordered_map>
-#include <stack>
+#include <vector>
+#include <deque>
+#include <unordered_set>
 #include "ComponentLibrary.h"
 #include "../Utils/Log.h"
+#include "../Rendering/StylePool.h"
+#include "../Utils/Hash.h"
+#include "../Utils/FrameArena.h"
+#include "State.h"
+#include "Context.h"
+#include "Signal.h"
+#include "ObservableList.h"
+#include <memory>
 
 namespace latte
 {
@@ -20,6 +30,46 @@ namespace latte
 		WIDGET_TYPE_TEXT
 	};
 
+	/*
+		Component types are interned when a library registers them, descriptors carry this id
+		instead of the "lib.Name" string. 0 is reserved for nodes that aren't components
+	*/
+	using ComponentTypeId = uint32_t;
+	constexpr ComponentTypeId COMPONENT_TYPE_NONE = 0;
+
+	struct ComponentType
+	{
+		// Full name, e.g. "ui.Text"
+		std::string name;
+		uint64_t nameHash = 0;
+
+		sol::protected_function ctor;
+
+		// Native widget the component is drawn as
+		WidgetType widgetType = WIDGET_TYPE_BOX;
+	};
+
+	/*
+		What applying a node's properties changed, decides which pipeline stages a rebuild needs
+	*/
+	enum NodeChange : uint32_t
+	{
+		NODE_CHANGE_NONE = 0,
+		NODE_CHANGE_PAINT = 1 << 0,		// Colors, borders, text content with the same size
+		NODE_CHANGE_LAYOUT = 1 << 1,	// Size, padding, spacing, alignment, position, measured text
+		NODE_CHANGE_STRUCTURE = 1 << 2	// Nodes were added or removed
+	};
+
+	/*
+		Priority of queued component work, lower lanes are always built first
+	*/
+	enum UpdateLane
+	{
+		UPDATE_LANE_INPUT,			// Updates caused by keyboard and mouse events
+		UPDATE_LANE_BACKGROUND,		// Everything else, effects, data loading, timers
+		UPDATE_LANE_COUNT
+	};
+
 	/*
 		State that we need to know/care about on the UI engine side
 
@@ -52,25 +102,98 @@ namespace latte
 	{
 		sol::protected_function func;
 
+		// Function returned by the last run of func, called before it runs again and on unmount
+		sol::protected_function cleanup = sol::nil;
+
 		// Dependencies passed as a table to latte.useEffect
 		// This is the last state of them
 		sol::table dependencies = sol::nil;
+
+		// Waiting in the component system's effect queue
+		bool queued = false;
+	};
+
+	/*
+		A cached value from latte.useMemo, only recomputed when its dependencies change
+	*/
+	struct ComponentMemo
+	{
+		sol::object value = sol::nil;
+
+		// Dependencies passed as a table to latte.useMemo
+		sol::table dependencies = sol::nil;
 	};
 
 	// This is a struct that gets attached to the user data of the node
 	struct ComponentData
 	{
+		// The node this data is attached to
+		LatteNode* node = nullptr;
+
+		// Identity of the node, a hash of the parent's id, the key or child index and the component type
+		uint64_t id = 0;
+
+		// Where this node sits in its parent's children table and the user key if it was given one
+		// Only kept so a readable path can be built with describeNode
+		int childIndex = 0;
+		std::string key;
+
 		WidgetType type;
-		sol::table style;
 
-		// Persistent state from the Lua side
-		sol::table state;
+		// Interned style compiled from the style table whenever props are applied
+		StyleId style = STYLE_ID_DEFAULT;
+
+		// Persistent state from latte.useState, shared with Lua
+		std::shared_ptr<State> state;
+
+		// States owned by other components that this one read in its last build
+		std::vector<std::weak_ptr<State>> stateReads;
 
 		std::unordered_map<ComponentEvent, sol::protected_function> eventCallbacks;
 
 		int effectOffset = 0;
 		std::vector<ComponentEffect> effects;
 
+		int memoOffset = 0;
+		std::vector<ComponentMemo> memos;
+
+		// The component this node was built from and the props it was last built with
+		// COMPONENT_TYPE_NONE for regular nodes that aren't components
+		ComponentTypeId componentType = COMPONENT_TYPE_NONE;
+		sol::table props;
+
+		// Fingerprint of the vnode last applied to this node, 0 if it had anything dynamic in it.
+		// An identical fingerprint means the whole subtree can be skipped
+		uint64_t fingerprint = 0;
+
+		// The latte.static table mounted here, kept alive so its pointer stays unique while frozen
+		sol::table staticSource;
+
+		// Signals bound to this node's fields, kept alive while bound
+		std::vector<std::shared_ptr<Signal>> signals;
+
+		// Set on nodes with items = ObservableList, there is one child per item built with itemBuilder
+		std::shared_ptr<ObservableList> list;
+		sol::protected_function itemBuilder;
+
+		// Set on Context.Provider nodes, the context they provide, its current value and the components reading it
+		ContextId providedContext = CONTEXT_NONE;
+		sol::object providedValue = sol::nil;
+		std::vector<ComponentData*> contextConsumers;
+
+		// Providers this component has read with latte.useContext
+		std::vector<ComponentData*> contextProviders;
+
+		// Set when the component has changed state and must be rebuilt
+		bool needsRebuild = false;
+
+		// Removed from its tree and waiting to be destroyed, nothing should build or notify it
+		bool detached = false;
+
+		// Is this node in one of the component system's work queues and which one
+		bool queued = false;
+		UpdateLane lane = UPDATE_LANE_BACKGROUND;
+
 		// For text widgets 
 		std::string text;
 		float fontSize;
@@ -83,26 +206,198 @@ namespace latte
 	{
 	public:
 
+		/*
+			Frees the pooled nodes, anything still mounted belongs to its window and is freed with it
+		*/
+		~ComponentSystem();
+
 		void setState(sol::state* s) { m_State = s; }
 
-		// void registerComponent(const std::string& name, sol::protected_function construct, const std::string& uiLib);
+		/*
+			Interns a component under its full "lib.Name" and returns the id descriptors should carry.
+			Registering a name twice replaces the constructor but keeps the id
+		*/
+		ComponentTypeId registerComponentType(const std::string& name, sol::protected_function ctor);
+
+		/*
+			Components with this full name are drawn as the given native widget instead of a box
+		*/
+		void registerNativeWidget(const std::string& name, WidgetType type);
+
+		[[nodiscard]] const ComponentType* getComponentType(ComponentTypeId id) const noexcept
+		{
+			if (id == COMPONENT_TYPE_NONE || id >= m_ComponentTypes.size())
+				return nullptr;
 
+			return &m_ComponentTypes[id];
+		}
+
+		// Slow path by name, the reconciler only uses ids
 		sol::protected_function getComponent(const std::string& name);
 
-		void pushID(const std::string& id) { m_IdStack.push(id); }
-		void popID() { m_IdStack.pop(); }
+		/*
+			The render context stack, the top is the node whose component is currently being built. 
+			Hooks use this to find their owner without searching the tree
+		*/
+		void pushNode(LatteNode* node) { m_RenderStack.push_back(node); }
+		void popNode() { m_RenderStack.pop_back(); }
+
+		[[nodiscard]] LatteNode* getCurrentNode() const noexcept
+		{
+			if (m_RenderStack.empty())
+				return nullptr;
+
+			return m_RenderStack.back();
+		}
 
-		const std::string getCurrentID() const { 
-			if (m_IdStack.size() == 0)
-				return std::string("");
+		/*
+			Returns the component data of the node currently being built, 
+			nullptr if nothing is being built or it is a window root
+		*/
+		[[nodiscard]] ComponentData* getCurrentData() const noexcept
+		{
+			LatteNode* node = getCurrentNode();
+			if (node == nullptr)
+				return nullptr;
 
-			return m_IdStack.top(); 
+			return (ComponentData*)latteGetUserData(node);
 		}
 
-		LatteNode* findNode(const std::string& id);
+		LatteNode* findNode(uint64_t id);
+
+		/*
+			Marks a component node as needing its builder re-run in the current update lane, 
+			only that component and its subtree are rebuilt
+		*/
+		void markDirty(LatteNode* node);
+
+		/*
+			The lane markDirty queues into, the event loop switches to the input lane while handling input
+		*/
+		void setUpdateLane(UpdateLane lane) noexcept { m_UpdateLane = lane; }
+		[[nodiscard]] UpdateLane getUpdateLane() const noexcept { return m_UpdateLane; }
+
+		/*
+			Queues a component to be built as its own unit of work, 
+			used for child components so a large rebuild can be split across frames
+		*/
+		void queueRender(LatteNode* node);
+
+		/*
+			Builds queued components one at a time, input lane first, until the deadline (SDL_GetTicksNS) passes.
+			Changes are recorded on each component's window. Returns true once there is no work left
+		*/
+		bool performWork(uint64_t deadlineNs);
+
+		[[nodiscard]] bool hasWork(UpdateLane lane) const noexcept { return m_WorkCount[lane] > 0; }
+		[[nodiscard]] bool hasWork() const noexcept;
+
+		/*
+			Roots of every tree that is part way through an update, some of a lane's work for it has been built
+			and some is still queued. Those windows shouldn't show a half built tree, a tree whose queued work
+			hasn't started yet is still whole. Allocated from the frame arena
+		*/
+		[[nodiscard]] std::pmr::unordered_set<LatteNode*> getBusyRoots() const;
+
+		/*
+			Removes a subtree from its parent straight away and queues it to be freed later by destroyDetached,
+			so a large removal doesn't free every node and Lua reference in the frame that caused it
+		*/
+		void detachNode(LatteNode* node);
+
+		/*
+			Frees queued subtrees bottom up until the deadline (SDL_GetTicksNS) passes, returns true once none are left
+		*/
+		bool destroyDetached(uint64_t deadlineNs);
+
+		/*
+			Returns a detached node with fresh component data for the given id, reusing one
+			recycled from a destroyed node of the same component type when there is one
+		*/
+		LatteNode* acquireNode(uint64_t id, ComponentTypeId type);
+
+		/*
+			Called when a node's component data is deleted so nothing keeps pointing at it
+		*/
+		void onComponentDataDestroyed(ComponentData* data);
+
+		/*
+			Called when a provider is built. If the value changed only the components that read it are marked dirty
+		*/
+		void provideContext(ComponentData* provider, ContextId context, sol::object value);
+
+		/*
+			Finds the nearest provider of the context above the consumer and registers the consumer on it,
+			returns the context's default if there is no provider
+		*/
+		sol::object readContext(ComponentData* consumer, const Context& context);
+
+		/*
+			Writes a signal's new value straight into the bound node and invalidates only the layout or paint of its window
+		*/
+		void patchSignalField(ComponentData* data, SignalField field, const Signal& signal);
+
+		/*
+			Applies one change record from the host's ObservableList to its children, 
+			only the inserted, removed, moved or updated items are touched
+		*/
+		void applyListChange(ComponentData* host, const ListChange& change);
+
+		/*
+			A latte.static table that has been mounted. Its contents can't change the reconciler's output
+			so while any node holds it, the table is recognised by pointer and never read again
+		*/
+		struct FrozenTable
+		{
+			uint64_t fingerprint = 0;
+			uint64_t keyHash = 0;
+			bool keyed = false;
+			int refs = 0;
+		};
+
+		void freezeTable(const sol::table& table, uint64_t fingerprint, uint64_t keyHash, bool keyed);
+		void unfreezeTable(const void* table);
+
+		[[nodiscard]] const FrozenTable* findFrozenTable(const void* table) const
+		{
+			if (m_FrozenTables.empty())
+				return nullptr;
+
+			auto itr = m_FrozenTables.find(table);
+			return itr != m_FrozenTables.end() ? &itr->second : nullptr;
+		}
+
+		/*
+			Effects are queued while components are built and only run once the commit has been presented,
+			so slow effects don't hold up the frame
+		*/
+		void queueEffect(ComponentData* data, int index);
+
+		/*
+			Runs queued effects, those from trees under heldRoots stay queued until their update has been presented
+		*/
+		void flushEffects(const std::pmr::unordered_set<LatteNode*>* heldRoots = nullptr);
+
+		void recordChange(uint32_t change) noexcept { m_Changes |= change; }
+
+		/*
+			Returns and clears the NodeChange flags recorded since the last call
+		*/
+		[[nodiscard]] uint32_t takeChanges() noexcept
+		{
+			uint32_t changes = m_Changes;
+			m_Changes = NODE_CHANGE_NONE;
+			return changes;
+		}
 
 		void setFocusedNode(LatteNode* node)
 		{
+			// Both the old and new focused components need to rebuild to reflect the change
+			if (m_FocusedNode)
+				markDirty(m_FocusedNode);
+			if (node)
+				markDirty(node);
+
 			m_FocusedNode = node;
 		}
 
@@ -129,21 +424,97 @@ namespace latte
 
 	private:
 
-		std::unordered_map<std::string, sol::protected_function> m_Components;
+		// Indexed by ComponentTypeId, slot 0 is the unused COMPONENT_TYPE_NONE
+		std::vector<ComponentType> m_ComponentTypes = { ComponentType{} };
+		std::unordered_map<std::string, ComponentTypeId> m_ComponentTypeIds;
+
+		std::unordered_map<std::string, WidgetType> m_NativeWidgets = {
+			{ "ui.Text", WIDGET_TYPE_TEXT }
+		};
 
 		std::unordered_map<std::string, std::shared_ptr<latte::ComponentLibrary>> m_Libraries;
 
 		sol::state* m_State;
 
-		std::stack<std::string> m_IdStack;
+		std::vector<LatteNode*> m_RenderStack;
+
+		void enqueueWork(LatteNode* node, ComponentData* data, UpdateLane lane);
+
+		struct QueuedWork
+		{
+			// Nulled when the node is freed or moved to another lane
+			LatteNode* node;
+			// Kept from when it was queued, a detached node no longer leads back to it
+			LatteNode* root;
+			uint32_t depth;
+		};
+
+		void releaseWork(UpdateLane lane, LatteNode* root, bool built);
+
+		// Component nodes waiting to be built per lane, kept ordered by depth so parents are built first
+		std::deque<QueuedWork> m_WorkQueues[UPDATE_LANE_COUNT];
+		size_t m_WorkCount[UPDATE_LANE_COUNT] = {};
+
+		struct LaneRoot
+		{
+			size_t queued = 0;
+			// Some of this lane's work for the root has been built, so its tree is part way through an update
+			bool started = false;
+		};
+
+		// Per lane, the trees with work queued in it. Entries are removed once their work is gone
+		std::unordered_map<LatteNode*, LaneRoot> m_LaneRoots[UPDATE_LANE_COUNT];
+
+		UpdateLane m_UpdateLane = UPDATE_LANE_BACKGROUND;
+
+		// Lane children deferred by the unit being built are queued in, 
+		// outside of performWork that is a root rebuild which is always treated as input
+		UpdateLane m_WorkLane = UPDATE_LANE_INPUT;
+
+		struct PendingEffect
+		{
+			// Nulled when the node is freed before the effect could run
+			ComponentData* data;
+			int index;
+		};
+
+		std::vector<PendingEffect> m_PendingEffects;
 
 		LatteNode* m_FocusedNode = nullptr;
 
+		uint32_t m_Changes = NODE_CHANGE_NONE;
+
+		std::unordered_map<const void*, FrozenTable> m_FrozenTables;
+
+		// Roots of detached subtrees, partly freed subtrees stay here until they're gone
+		std::vector<LatteNode*> m_DestroyQueue;
+
+		// Frees a detached leaf, or resets it and keeps it in the pool for its component type
+		void recycleNode(LatteNode* node);
+
+		// Nodes kept per component type are bounded so a one off burst doesn't hold its memory forever
+		static constexpr size_t NODE_POOL_LIMIT = 256;
+
+		// Reset nodes and their component data indexed by ComponentTypeId, plain elements are in slot 0.
+		// Their containers keep their capacity and they hold no Lua references
+		std::vector<std::vector<LatteNode*>> m_NodePool;
+
 
 		
 	};
 
 	void applyPropsFromTable(LatteNode* node, sol::table table, bool applyForThis = true);
+
+	/*
+		The identity of any node, window roots hash their name as they carry no component data
+	*/
+	uint64_t getNodeId(LatteNode* node);
+
+	/*
+		Builds a readable path like "Main_root/3.ui.Container/submit" for logs and tools,
+		this walks to the root so keep it out of hot paths
+	*/
+	std::string describeNode(LatteNode* node);
 }
 
 #endif // LATTE_COMPONENT_H
\ No newline at end of file
@@ -4,12 +4,14 @@ extern "C" {
 }
 #include "Component.h"
 #include <variant>
+#include <bit>
+#include <utility>
 #include "../Utils/Log.h"
 #include "../OS/EventLoop.h"
 
 namespace latte
 {
-    bool handleNodeEvent(Event evnt, LatteNode* node, sol::state_view luaState)
+    bool handleNodeEvent(const Event& evnt, LatteNode* node, sol::state_view luaState)
     {
         bool handled = false;
         for (int i = 0; i < node->childCount; i++)
@@ -88,7 +90,7 @@ namespace latte
                                 bool removeFocus = true;
                                 if (passEvent(COMPONENT_EVENT_CLICK, exData))
                                 {
-                                    Log::log(Log::Severity::Info, "Clicked Node: {}", std::string(node->id));
+                                    Log::log(Log::Severity::Info, "Clicked Node: {}", describeNode(node));
 
                                     // Kind of bad way of removing focus
                                     // Remove focus if the clicked node does not equal the focused node
@@ -100,17 +102,10 @@ namespace latte
                                     handled = true;
                                 }
 
+                                // Losing focus marks the previously focused component dirty
                                 if (removeFocus)
-                                {
                                     ComponentSystem::getInstance().setFocusedNode(nullptr);
 
-                                    // Trigger a relayout
-                                    // Very scuffed needs a fix
-                                    latte::EventLoop::getInstance().getWindowManager().foreach([&](std::shared_ptr<latte::Window> win) {
-                                        latte::EventLoop::getInstance().pushRelayout(win);
-                                    });
-                                }
-
                                 
                             }
 
@@ -122,20 +117,18 @@ namespace latte
                 }
                 else if constexpr (std::is_same_v<T, KeyDownEvent>)
                 {
-                    sol::table keyMod = luaState.create_table();
-
-                    for (const auto& mod : e.keyMods) {
-                        if (mod == "left shift")    keyMod["leftShift"] = true;
-                        else if (mod == "right shift")   keyMod["rightShift"] = true;
-                        else if (mod == "left ctrl")    keyMod["leftCtrl"] = true;
-                        else if (mod == "right ctrl")    keyMod["rightCtrl"] = true;
-                        else if (mod == "left alt")     keyMod["leftAlt"] = true;
-                        else if (mod == "right alt")     keyMod["rightAlt"] = true;
-                        else if (mod == "left gui")     keyMod["leftGui"] = true;
-                        else if (mod == "right gui")     keyMod["rightGui"] = true;
-                       /* else if (mod == "num")      keyMod["num"] = true;
-                        else if (mod == "caps")     keyMod["caps"] = true;
-                        else if (mod == "mode")     keyMod["mode"] = true;*/
+                    static constexpr std::pair<KeyMod, const char*> s_KeyModNames[] = {
+                        { KEY_MOD_LEFT_SHIFT, "leftShift" }, { KEY_MOD_RIGHT_SHIFT, "rightShift" },
+                        { KEY_MOD_LEFT_CTRL, "leftCtrl" }, { KEY_MOD_RIGHT_CTRL, "rightCtrl" },
+                        { KEY_MOD_LEFT_ALT, "leftAlt" }, { KEY_MOD_RIGHT_ALT, "rightAlt" },
+                        { KEY_MOD_LEFT_GUI, "leftGui" }, { KEY_MOD_RIGHT_GUI, "rightGui" }
+                    };
+
+                    sol::table keyMod = luaState.create_table(0, std::popcount(e.keyMods));
+                    for (const auto& [mod, name] : s_KeyModNames)
+                    {
+                        if (e.keyMods & mod)
+                            keyMod[name] = true;
                     }
 
                     if (passEvent(COMPONENT_EVENT_KEY_DOWN, e.name, keyMod))
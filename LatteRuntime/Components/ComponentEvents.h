@@ -9,7 +9,7 @@ typedef struct LatteNode LatteNode;
 
 namespace latte
 {
-	bool handleNodeEvent(Event evnt, LatteNode* node, sol::state_view luaState);
+	bool handleNodeEvent(const Event& evnt, LatteNode* node, sol::state_view luaState);
 }
 
 #endif // LATTE_COMPONENT_EVENTS_H
\ No newline at end of file
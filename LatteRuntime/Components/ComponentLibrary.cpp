@@ -1,6 +1,7 @@
 
 #include "ComponentLibrary.h"
 #include "../Utils/Log.h"
+#include "Component.h"
 
 namespace latte
 {
@@ -30,22 +31,21 @@ namespace latte
 			return;
 		}
 
-		auto wrapper = [this, name, builder](sol::table props) -> sol::object
+		// Interned once here so the reconciler resolves the builder with an index
+		ComponentTypeId typeId = ComponentSystem::getInstance().registerComponentType(m_Name + "." + name, builder);
+
+		// The wrapper only describes the component, the builder itself is run by the reconciler
+		// so it gets the correct hook context and can be skipped when memoized
+		auto wrapper = [typeId](sol::this_state s, sol::table props) -> sol::object
 			{
-				// Call the original component function
-				sol::protected_function_result result = builder(props);
-                
-				if (!result.valid())
-				{
-					sol::error err = result;
-					Log::log(Log::Severity::Error, "Component {} failed: {}", name, err.what());
-					return sol::nil;
-				}
-
-				sol::table componentTable = result;
-				componentTable["component_type"] = m_Name + "." + name;
+				sol::table componentTable = sol::state_view(s).create_table();
+				componentTable["component_type"] = typeId;
 				componentTable["original_props"] = props;
 
+				sol::object id = props["id"];
+				if (id.valid())
+					componentTable["id"] = id;
+
 				return componentTable;
 			};
 
@@ -0,0 +1,62 @@
+#include "Context.h"
+#include "Component.h"
+
+namespace latte
+{
+	static ContextId s_NextContextId = 1;
+
+	// Every provider shares one component type, the context id is passed through its props
+	static ComponentTypeId s_ProviderType = COMPONENT_TYPE_NONE;
+
+	static sol::table buildProvider(sol::table props)
+	{
+		ComponentData* data = ComponentSystem::getInstance().getCurrentData();
+		if (data != nullptr)
+			ComponentSystem::getInstance().provideContext(data, props.get_or<ContextId>("__latte_context", CONTEXT_NONE), props.get<sol::object>("value"));
+
+		// value and the context id are ignored by the reconciler, so the props are the provider's element
+		return props;
+	}
+
+	Context::Context(sol::state_view state, sol::object defaultValue) : m_Id(s_NextContextId++), m_Default(defaultValue)
+	{
+		ContextId id = m_Id;
+		ComponentTypeId typeId = s_ProviderType;
+
+		auto provider = [id, typeId](sol::this_state s, sol::table props) -> sol::table
+			{
+				sol::state_view lua(s);
+
+				// Copied so the user's table isn't changed
+				sol::table providerProps = lua.create_table();
+				for (const auto& kv : props)
+					providerProps[kv.first] = kv.second;
+
+				providerProps["__latte_context"] = id;
+
+				sol::table componentTable = lua.create_table();
+				componentTable["component_type"] = typeId;
+				componentTable["original_props"] = providerProps;
+
+				sol::object key = props["id"];
+				if (key.valid())
+					componentTable["id"] = key;
+
+				return componentTable;
+			};
+
+		m_Provider = sol::make_object(state, provider);
+	}
+
+	void Context::luaRegister(sol::state_view state)
+	{
+		sol::protected_function ctor = sol::make_object(state, &buildProvider).as<sol::protected_function>();
+		s_ProviderType = ComponentSystem::getInstance().registerComponentType("latte.Provider", ctor);
+
+		state.new_usertype<latte::Context>("Context",
+			sol::no_constructor,
+			"Provider", sol::readonly_property(&latte::Context::getProvider),
+			"default", sol::readonly_property(&latte::Context::getDefault)
+		);
+	}
+}
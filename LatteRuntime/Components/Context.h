@@ -0,0 +1,42 @@
+#ifndef LATTE_CONTEXT_H
+#define LATTE_CONTEXT_H
+
+#include <sol/sol.hpp>
+#include <cstdint>
+
+namespace latte
+{
+	using ContextId = uint32_t;
+	constexpr ContextId CONTEXT_NONE = 0;
+
+	/*
+		The object returned by latte.createContext.
+
+		Context.Provider({ value = v, children = {...} }) makes v visible to every component below it,
+		latte.useContext(Context) reads the nearest provider's value or the default if there isn't one.
+		Components that read a context are registered on the provider so a new value only rebuilds them
+	*/
+	class Context
+	{
+	public:
+
+		Context(sol::state_view state, sol::object defaultValue);
+
+		[[nodiscard]] ContextId getId() const noexcept { return m_Id; }
+		[[nodiscard]] const sol::object& getDefault() const noexcept { return m_Default; }
+		[[nodiscard]] const sol::object& getProvider() const noexcept { return m_Provider; }
+
+		static void luaRegister(sol::state_view state);
+
+	private:
+
+		ContextId m_Id = CONTEXT_NONE;
+
+		sol::object m_Default;
+
+		// The Provider component function, describes a provider for this context
+		sol::object m_Provider;
+	};
+}
+
+#endif // LATTE_CONTEXT_H
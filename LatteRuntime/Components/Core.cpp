@@ -7,9 +7,26 @@
 #include "Focus.h"
 #include "../Rendering/FontMetrics.h"
 #include "../OS/EventLoop.h"
+#include "../Rendering/StylePool.h"
+#include "BaseHelpers.h"
+#include "FastPath.h"
+#include "../Utils/ScriptCache.h"
+#include <cstdio>
+#include <algorithm>
+#include <memory>
+#include <format>
+#include <stdexcept>
 
 namespace latte
 {
+	// Node ids are 64-bit and Lua numbers can't hold them exactly, so they cross over as hex strings
+	static std::string nodeIdToString(uint64_t id)
+	{
+		char buffer[17];
+		snprintf(buffer, sizeof(buffer), "%016llx", (unsigned long long)id);
+		return std::string(buffer);
+	}
+
 	void bindCoreFunctions(sol::state_view state)
 	{
 		sol::table latteTable = state.create_named_table("latte");
@@ -120,15 +137,12 @@ namespace latte
 			};
 
 		latteTable["useEffect"] =
-			[&](sol::protected_function func, sol::table deps) -> void {
+			[](sol::protected_function func, sol::table deps) -> void {
 
-			std::string str = latte::ComponentSystem::getInstance().getCurrentID();
-			LatteNode* node = latte::ComponentSystem::getInstance().findNode(str);
-			if (node == nullptr)
+			latte::ComponentData* data = latte::ComponentSystem::getInstance().getCurrentData();
+			if (data == nullptr)
 				return;
 
-			latte::ComponentData* data = (latte::ComponentData*)latteGetUserData(node);
-
 			int effectOffset = data->effectOffset;
 			if (effectOffset >= data->effects.size())
 				data->effects.resize(effectOffset + 1);
@@ -137,126 +151,164 @@ namespace latte
 
 			bool first_render = (eff.dependencies == sol::nil);
 
-			if (first_render)
+			// Always the latest closure, so an effect queued by an earlier build doesn't run with stale upvalues
+			eff.func = func;
+
+			// Runs on mount and whenever deps differ, but only after this build has been committed
+			if (first_render || !latte::shallowTableEqual(eff.dependencies, deps))
 			{
-				eff.func = func;
-				eff.dependencies = deps;
-				// Call immediately on mount
-				eff.func();
+				eff.dependencies = deps; // Save updated deps
+				latte::ComponentSystem::getInstance().queueEffect(data, effectOffset);
 			}
-			else
-			{
-				// Check if deps differ
-				if (!latte::shallowTableEqual(eff.dependencies, deps))
+
+			data->effectOffset++;
+			};
+
+		latteTable["useMemo"] =
+			[](sol::protected_function func, sol::table deps) -> sol::object {
+
+			auto compute = [&]() -> sol::object {
+				sol::protected_function_result result = func();
+				if (!result.valid())
 				{
-					eff.func();
-					eff.dependencies = deps; // Save updated deps
+					sol::error err = result;
+					latte::Log::log(latte::Log::Severity::Error, "useMemo function failed: {}", err.what());
+					return sol::nil;
 				}
-				// If they are the same, do nothing
+
+				return result.get<sol::object>();
+				};
+
+			latte::ComponentData* data = latte::ComponentSystem::getInstance().getCurrentData();
+			if (data == nullptr)
+				return compute();
+
+			int memoOffset = data->memoOffset;
+			if (memoOffset >= data->memos.size())
+				data->memos.resize(memoOffset + 1);
+
+			data->memoOffset++;
+
+			auto& memo = data->memos[memoOffset];
+
+			// Recompute on first render or when the dependencies differ
+			if (memo.dependencies == sol::nil || !latte::shallowTableEqual(memo.dependencies, deps))
+			{
+				memo.value = compute();
+				memo.dependencies = deps;
 			}
 
-			data->effectOffset++;
+			return memo.value;
 			};
 
-		latteTable["useState"] = [&](sol::table input_table) {
-			std::string str = latte::ComponentSystem::getInstance().getCurrentID();
-			LatteNode* node = latte::ComponentSystem::getInstance().findNode(str);
-			if (node == nullptr)
+		latteTable["useState"] = [](sol::this_state s, sol::table input_table) -> sol::object {
+			latte::ComponentData* data = latte::ComponentSystem::getInstance().getCurrentData();
+			if (data == nullptr)
 				return input_table;
 
-			sol::table& stored_table =
-				((latte::ComponentData*)latteGetUserData(node))->state;
-
-			if (!stored_table.valid() || stored_table == sol::nil) {
-				stored_table = state.create_table();
+			if (!data->state) {
+				sol::table values = sol::state_view(s).create_table();
 
 				// Merge input_table fields, only on first creation
 				if (input_table.valid()) {
 					for (const auto& kv : input_table) {
-						stored_table.set(kv.first, kv.second);
+						values.set(kv.first, kv.second);
 					}
 				}
+
+				data->state = std::make_shared<latte::State>(values, data->node);
 			}
 
-			stored_table["__latte_node_id"] = str;
-			stored_table["__latte_magic"] = "latte_state_table";
+			// Return the persistent state object
+			return sol::make_object(s, data->state);
+			};
 
-			stored_table["setState"] = [](sol::this_state s, sol::table self, sol::table new_state) {
-				std::string id = self["__latte_node_id"];
-				LatteNode* node = latte::ComponentSystem::getInstance().findNode(id);
-				if (node == nullptr)
-					return;
 
-				// Always get the latest state table directly from node
-				sol::table node_stored_table = ((latte::ComponentData*)latteGetUserData(node))->state;
+		latteTable["createContext"] =
+			[](sol::this_state s, sol::object defaultValue) -> std::shared_ptr<latte::Context> {
+			return std::make_shared<latte::Context>(sol::state_view(s), defaultValue);
+			};
 
-				for (const auto& kv : new_state)
-				{
-					// Convert key to string
-					std::string key_str;
-					if (kv.first.is<int>()) {
-						key_str = std::to_string(kv.first.as<int>());
-					}
-					else if (kv.first.is<std::string>()) {
-						key_str = kv.first.as<std::string>();
-					}
-					else {
-						key_str = "<unknown type>";
-					}
+		latteTable["useContext"] =
+			[](const latte::Context& context) -> sol::object {
 
-					// Convert value to string for debug (primitive types only here)
-					std::string value_str;
-					if (kv.second.is<bool>()) {
-						value_str = kv.second.as<bool>() ? "true" : "false";
-					}
-					else if (kv.second.is<int>()) {
-						value_str = std::to_string(kv.second.as<int>());
-					}
-					else if (kv.second.is<double>()) {
-						value_str = std::to_string(kv.second.as<double>());
-					}
-					else if (kv.second.is<std::string>()) {
-						value_str = kv.second.as<std::string>();
-					}
-					else if (kv.second.is<sol::table>()) {
-						value_str = "<table>";
-					}
-					else if (kv.second.is<sol::function>()) {
-						value_str = "<function>";
-					}
-					else {
-						value_str = "<unknown type>";
-					}
+			latte::ComponentData* data = latte::ComponentSystem::getInstance().getCurrentData();
+			if (data == nullptr)
+				return context.getDefault();
 
-					latte::Log::log(latte::Log::Severity::Info, "setState: Setting \"{}\" = {}", key_str, value_str);
+			// Registers this component on the provider, a new value only rebuilds the components that read it
+			return latte::ComponentSystem::getInstance().readContext(data, context);
+			};
 
-					node_stored_table.set(kv.first, kv.second);
+		latteTable["signal"] =
+			[](sol::object value) -> std::shared_ptr<latte::Signal> {
+			return std::make_shared<latte::Signal>(value);
+			};
 
-				}
+		latteTable["ObservableList"] =
+			[](sol::object initial) -> std::shared_ptr<latte::ObservableList> {
+			return std::make_shared<latte::ObservableList>(initial);
+			};
 
-				// Very scuffed needs a fix
-				latte::EventLoop::getInstance().getWindowManager().foreach([&](std::shared_ptr<latte::Window> win) {
-					latte::EventLoop::getInstance().pushRelayout(win);
-					});
+		latteTable["getID"] =
+			[]() -> std::string {
 
-				};
+			LatteNode* node = latte::ComponentSystem::getInstance().getCurrentNode();
+			if (node == nullptr)
+				return std::string("");
 
-			// Return the persistent state table
-			return stored_table;
+			return latte::describeNode(node);
 			};
 
+		latteTable["getIDHash"] =
+			[]() -> std::string {
 
-		latteTable["getID"] =
-			[&]() -> const std::string& {
+			LatteNode* node = latte::ComponentSystem::getInstance().getCurrentNode();
+			if (node == nullptr)
+				return std::string("");
 
-			return latte::ComponentSystem::getInstance().getCurrentID();
+			return nodeIdToString(latte::getNodeId(node));
 			};
 
 		latteTable["useFocus"] =
 			[&]() -> latte::Focus {
 
-			std::string str = latte::ComponentSystem::getInstance().getCurrentID();
-			return latte::Focus(str);
+			LatteNode* node = latte::ComponentSystem::getInstance().getCurrentNode();
+			if (node == nullptr)
+				return latte::Focus(0);
+
+			return latte::Focus(latte::getNodeId(node));
+			};
+
+		latteTable["batch"] =
+			[](sol::protected_function func) -> void {
+
+			// Everything set inside the function is committed together in one frame
+			latte::EventLoop::getInstance().beginBatch();
+			sol::protected_function_result result = func();
+			latte::EventLoop::getInstance().endBatch();
+
+			if (!result.valid())
+			{
+				sol::error err = result;
+				latte::Log::log(latte::Log::Severity::Error, "latte.batch function failed: {}", err.what());
+			}
+			};
+
+		latteTable["getStyleStats"] =
+			[](sol::this_state s) -> sol::table {
+
+			const latte::StylePool& pool = latte::StylePool::getInstance();
+
+			sol::table stats = sol::state_view(s).create_table();
+			stats["size"] = pool.size();
+			stats["hits"] = pool.getHits();
+			stats["misses"] = pool.getMisses();
+			stats["hitRate"] = pool.getHitRate();
+			stats["compileHits"] = latte::getStyleCompileHits();
+			stats["compileMisses"] = latte::getStyleCompileMisses();
+
+			return stats;
 			};
 
 		latteTable["getFontMetrics"] =
@@ -264,43 +316,138 @@ namespace latte
 
 			return latte::FontMetrics(fontFace, size, state);
 			};
+
+		latte::bindBaseHelpers(state, latteTable);
+		latte::bindFastPaths(state, latteTable);
 	}
 
-	bool loadDependencyScripts(sol::state_view state, const std::string& basePath)
+	static bool runDependencyScript(sol::state_view state, const std::string& path)
 	{
-		// This is ordered, they will get loaded in this order
-		// For instance components depends on base and textedit
-		std::vector<std::string> deps = {
-			"latte-base.lua",
-			"latte-textedit.lua",
-			"latte-components.lua",
-			"latte-fluentui.lua",
-			"latte-material3.lua"
-		};
+		sol::load_result loaded = latte::ScriptCache::getInstance().load(state, path);
+		if (!loaded.valid()) 
+		{
+			sol::error err = loaded;
+			latte::Log::log(latte::Log::Severity::Error, "Load error in '{}': {}", path, err.what());
+			return false;
+		}
 
-		for (std::string& script : deps)
+		sol::protected_function func = loaded;
+		sol::protected_function_result result = func();
+
+		if (!result.valid()) 
 		{
-			std::string path = basePath + script;
+			sol::error err = result;
+			latte::Log::log(latte::Log::Severity::Error, "Runtime error in '{}': {}", path, err.what());
+			return false;
+		}
+
+		return true;
+	}
+
+	/*
+		A library script that is only run the first time one of the keys it defines on latte is read
+	*/
+	struct LazyModule
+	{
+		const char* script;
+
+		// Keys this script sets on the latte table
+		std::vector<std::string> provides;
+
+		// Indices of modules that are loaded before this one
+		std::vector<size_t> dependsOn;
+	};
+
+	enum LazyModuleState : uint8_t
+	{
+		LAZY_MODULE_UNLOADED,
+		LAZY_MODULE_LOADING,
+		LAZY_MODULE_LOADED,
+		LAZY_MODULE_FAILED
+	};
+
+	static const std::vector<LazyModule>& getLazyModules()
+	{
+		// TextField and MultiLineTextField read latte.useTextEdit when they're built, 
+		// so text editing is only loaded by apps that actually show one
+		static const std::vector<LazyModule> s_Modules = {
+			{ "latte-textedit.lua", { "useTextEdit", "useMultiLineTextEdit" }, {} },
+			{ "latte-components.lua", { "ui" }, {} },
+			{ "latte-fluentui.lua", { "fluent" }, { 1 } },
+			{ "latte-material3.lua", { "material" }, { 1 } }
+		};
 
-			sol::load_result loaded = state.load_file(path);
-			if (!loaded.valid()) 
+		return s_Modules;
+	}
+
+	static bool loadLazyModule(sol::state_view state, const std::string& basePath, std::vector<LazyModuleState>& states, size_t index)
+	{
+		// Loading already, a library reads its own name from latte while it is being created
+		if (states[index] != LAZY_MODULE_UNLOADED)
+			return states[index] != LAZY_MODULE_FAILED;
+
+		states[index] = LAZY_MODULE_LOADING;
+
+		const LazyModule& module = getLazyModules()[index];
+		for (size_t dependency : module.dependsOn)
+		{
+			if (!loadLazyModule(state, basePath, states, dependency))
 			{
-				sol::error err = loaded;
-				latte::Log::log(latte::Log::Severity::Error, "Load error in '{}': {}", path, err.what());
+				states[index] = LAZY_MODULE_FAILED;
 				return false;
 			}
+		}
 
-			sol::protected_function func = loaded;
-			sol::protected_function_result result = func();
+		latte::Log::log(latte::Log::Severity::Info, "Loading {} on first use", module.script);
+
+		bool loaded = runDependencyScript(state, basePath + module.script);
+		states[index] = loaded ? LAZY_MODULE_LOADED : LAZY_MODULE_FAILED;
+		return loaded;
+	}
+
+	bool loadDependencyScripts(sol::state_view state, const std::string& basePath)
+	{
+		// Everything else builds on base so it is always loaded up front
+		if (!runDependencyScript(state, basePath + "latte-base.lua"))
+			return false;
 
-			if (!result.valid()) 
+		// The component libraries are loaded the first time the app reads them from latte,
+		// a missing key on latte goes through here so the libraries can be found by name
+		auto states = std::make_shared<std::vector<LazyModuleState>>(getLazyModules().size(), LAZY_MODULE_UNLOADED);
+
+		sol::table meta = state.create_table();
+		meta[sol::meta_function::index] =
+			[basePath, states](sol::this_state s, sol::table self, sol::stack_object key) -> sol::object {
+
+			if (key.get_type() != sol::type::string)
+				return sol::nil;
+
+			const std::string_view name = key.as<std::string_view>();
+			const std::vector<LazyModule>& modules = getLazyModules();
+			for (size_t i = 0; i < modules.size(); i++)
 			{
-				sol::error err = result;
-				latte::Log::log(latte::Log::Severity::Error, "Runtime error in '{}': {}", path, err.what());
-				return false;
+				if (std::find(modules[i].provides.begin(), modules[i].provides.end(), name) == modules[i].provides.end())
+					continue;
+
+				// Still being created, the library is reading its own keys before it has set them
+				if ((*states)[i] == LAZY_MODULE_LOADING)
+					return self.raw_get<sol::object>(key);
+
+				if ((*states)[i] == LAZY_MODULE_UNLOADED)
+					loadLazyModule(sol::state_view(s), basePath, *states, i);
+
+				// Raised as a Lua error, returning nil would only fail later with a far less useful message
+				if ((*states)[i] == LAZY_MODULE_FAILED)
+					throw std::runtime_error(std::format("latte.{} is unavailable, {} failed to load", name, modules[i].script));
+
+				return self.raw_get<sol::object>(key);
 			}
-		}
+
+			return sol::nil;
+			};
+
+		state["latte"].get<sol::table>()[sol::metatable_key] = meta;
 
 		return true; 
 	}
-}
\ No newline at end of file
+}
@@ -9,6 +9,10 @@ namespace latte
 {
 	void bindCoreFunctions(sol::state_view state);
 
+	/*
+		Runs latte-base.lua and sets up latte so the component libraries, latte.ui, latte.fluent and latte.material,
+		and text editing are only loaded the first time they're read. Reading one whose script failed raises a Lua error
+	*/
 	bool loadDependencyScripts(sol::state_view state, const std::string& basePath);
 }
 
@@ -0,0 +1,54 @@
+#include "FastPath.h"
+#include "Component.h"
+#include "Focus.h"
+#include "../Rendering/FontMetrics.h"
+
+extern "C"
+{
+	uint64_t latteFastCurrentNodeId(void)
+	{
+		LatteNode* node = latte::ComponentSystem::getInstance().getCurrentNode();
+		return node ? latte::getNodeId(node) : 0;
+	}
+
+	bool latteFastIsFocused(uint64_t id)
+	{
+		return latte::Focus(id).isFocused();
+	}
+
+	void latteFastRequestFocus(uint64_t id)
+	{
+		latte::Focus(id).request();
+	}
+
+	float latteFastTextSize(const char* fontFace, float fontSize, const char* str, size_t length, float* height)
+	{
+		return latte::FontMetrics::measureText(fontFace, fontSize, str, length, height);
+	}
+
+	float latteFastLineHeight(const char* fontFace, float fontSize)
+	{
+		return latte::FontMetrics::measureLineHeight(fontFace, fontSize);
+	}
+}
+
+namespace latte
+{
+	template <typename Func>
+	static sol::lightuserdata_value address(Func* func)
+	{
+		return sol::lightuserdata_value(reinterpret_cast<void*>(func));
+	}
+
+	void bindFastPaths(sol::state_view state, sol::table latteTable)
+	{
+		sol::table functions = state.create_table();
+		functions["currentNodeId"] = address(&latteFastCurrentNodeId);
+		functions["isFocused"] = address(&latteFastIsFocused);
+		functions["requestFocus"] = address(&latteFastRequestFocus);
+		functions["textSize"] = address(&latteFastTextSize);
+		functions["lineHeight"] = address(&latteFastLineHeight);
+
+		latteTable["__ffi"] = functions;
+	}
+}
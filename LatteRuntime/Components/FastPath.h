@@ -0,0 +1,37 @@
+#ifndef LATTE_FAST_PATH_H
+#define LATTE_FAST_PATH_H
+
+#include <sol/sol.hpp>
+#include <cstdint>
+#include <cstddef>
+
+/*
+	A plain C ABI for engine calls made from hot Lua code. 
+	LuaJIT calls these through the FFI, which the JIT compiles into a direct call,
+	instead of going through sol's usertype dispatch.
+
+	None of these can call back into Lua, that isn't allowed from an FFI call
+*/
+extern "C"
+{
+	// Identity of the component being built, 0 outside of a build
+	uint64_t latteFastCurrentNodeId(void);
+
+	bool latteFastIsFocused(uint64_t id);
+	void latteFastRequestFocus(uint64_t id);
+
+	// Width of length bytes of str, the height is written to height if it isn't null
+	float latteFastTextSize(const char* fontFace, float fontSize, const char* str, size_t length, float* height);
+	float latteFastLineHeight(const char* fontFace, float fontSize);
+}
+
+namespace latte
+{
+	/*
+		Sets latte.__ffi to the addresses of the functions above, latte-base.lua casts them with the FFI.
+		Passing addresses means nothing has to be exported for ffi.C, which can't see into a shared library on every platform
+	*/
+	void bindFastPaths(sol::state_view state, sol::table latteTable);
+}
+
+#endif // LATTE_FAST_PATH_H
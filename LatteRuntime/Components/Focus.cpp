@@ -3,7 +3,7 @@
 
 namespace latte
 {
-	Focus::Focus(const std::string& id) : m_ID(id)
+	Focus::Focus(uint64_t id) : m_ID(id)
 	{
 	}
 
@@ -13,12 +13,12 @@ namespace latte
 		if (focusedNode == nullptr)
 			return false;
 
-		return std::string(focusedNode->id) == m_ID;
+		return latte::getNodeId(focusedNode) == m_ID;
 	}
 
 	void Focus::request()
 	{
-		if (m_ID.empty())
+		if (m_ID == 0)
 			return;
 
 		LatteNode* node = latte::ComponentSystem::getInstance().findNode(m_ID);
@@ -27,7 +27,7 @@ namespace latte
 			return;
 
 		latte::ComponentSystem::getInstance().setFocusedNode(node);
-		latte::Log::log(latte::Log::Severity::Info, "Set node has focus: {}", m_ID);
+		latte::Log::log(latte::Log::Severity::Info, "Set node has focus: {}", latte::describeNode(node));
 	}
 
 	void Focus::luaRegister(sol::state_view state)
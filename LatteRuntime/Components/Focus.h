@@ -3,6 +3,7 @@
 #define LATTE_FOCUS_H
 
 #include <sol/sol.hpp>
+#include <cstdint>
 
 namespace latte
 {
@@ -10,7 +11,7 @@ namespace latte
 	{
 	public:
 
-		Focus(const std::string& id);
+		Focus(uint64_t id);
 
 		bool isFocused();
 
@@ -20,7 +21,8 @@ namespace latte
 
 	private:
 
-		std::string m_ID = "";
+		// Node identity, 0 when the focus isn't attached to a node
+		uint64_t m_ID = 0;
 	};
 }
 
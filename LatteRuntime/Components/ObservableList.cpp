@@ -0,0 +1,135 @@
+#include "ObservableList.h"
+#include "Component.h"
+#include "../Utils/Log.h"
+#include <algorithm>
+
+namespace latte
+{
+	ObservableList::ObservableList(sol::object initial)
+	{
+		if (initial.get_type() != sol::type::table)
+			return;
+
+		sol::table table = initial.as<sol::table>();
+		size_t count = table.size();
+
+		m_Items.reserve(count);
+		for (size_t i = 1; i <= count; i++)
+			m_Items.push_back({ table.get<sol::object>(i), m_NextId++ });
+	}
+
+	void ObservableList::insert(int index, sol::object value)
+	{
+		if (index < 1 || index > (int)m_Items.size() + 1)
+		{
+			Log::log(Log::Severity::Warning, "ObservableList:insert index {} is out of range, size is {}", index, m_Items.size());
+			return;
+		}
+
+		m_Items.insert(m_Items.begin() + (index - 1), { value, m_NextId++ });
+		emit({ LIST_CHANGE_INSERT, (uint32_t)(index - 1), 1 });
+	}
+
+	void ObservableList::push(sol::object value)
+	{
+		m_Items.push_back({ value, m_NextId++ });
+		emit({ LIST_CHANGE_INSERT, (uint32_t)(m_Items.size() - 1), 1 });
+	}
+
+	void ObservableList::remove(int index, sol::optional<int> count)
+	{
+		int removeCount = count.value_or(1);
+		if (index < 1 || index > (int)m_Items.size() || removeCount < 1)
+		{
+			Log::log(Log::Severity::Warning, "ObservableList:remove index {} is out of range, size is {}", index, m_Items.size());
+			return;
+		}
+
+		removeCount = std::min(removeCount, (int)m_Items.size() - index + 1);
+
+		m_Items.erase(m_Items.begin() + (index - 1), m_Items.begin() + (index - 1 + removeCount));
+		emit({ LIST_CHANGE_REMOVE, (uint32_t)(index - 1), (uint32_t)removeCount });
+	}
+
+	void ObservableList::move(int from, int to)
+	{
+		int size = (int)m_Items.size();
+		if (from < 1 || from > size || to < 1 || to > size)
+		{
+			Log::log(Log::Severity::Warning, "ObservableList:move from {} to {} is out of range, size is {}", from, to, size);
+			return;
+		}
+
+		if (from == to)
+			return;
+
+		Item item = std::move(m_Items[from - 1]);
+		m_Items.erase(m_Items.begin() + (from - 1));
+		m_Items.insert(m_Items.begin() + (to - 1), std::move(item));
+
+		emit({ LIST_CHANGE_MOVE, (uint32_t)(from - 1), 1, (uint32_t)(to - 1) });
+	}
+
+	void ObservableList::update(int index, sol::object value)
+	{
+		if (index < 1 || index > (int)m_Items.size())
+		{
+			Log::log(Log::Severity::Warning, "ObservableList:update index {} is out of range, size is {}", index, m_Items.size());
+			return;
+		}
+
+		m_Items[index - 1].value = value;
+		emit({ LIST_CHANGE_UPDATE, (uint32_t)(index - 1), 1 });
+	}
+
+	void ObservableList::clear()
+	{
+		if (m_Items.empty())
+			return;
+
+		uint32_t count = (uint32_t)m_Items.size();
+		m_Items.clear();
+		emit({ LIST_CHANGE_REMOVE, 0, count });
+	}
+
+	sol::object ObservableList::get(int index) const
+	{
+		if (index < 1 || index > (int)m_Items.size())
+			return sol::nil;
+
+		return m_Items[index - 1].value;
+	}
+
+	void ObservableList::bind(ComponentData* host)
+	{
+		m_Hosts.push_back(host);
+	}
+
+	void ObservableList::unbind(ComponentData* host)
+	{
+		std::erase(m_Hosts, host);
+	}
+
+	void ObservableList::emit(const ListChange& change)
+	{
+		// Indexed, an item builder could bind or unbind hosts while the change is applied
+		for (size_t i = 0; i < m_Hosts.size(); i++)
+			ComponentSystem::getInstance().applyListChange(m_Hosts[i], change);
+	}
+
+	void ObservableList::luaRegister(sol::state_view state)
+	{
+		state.new_usertype<latte::ObservableList>("ObservableList",
+			sol::no_constructor,
+			"insert", &latte::ObservableList::insert,
+			"push", &latte::ObservableList::push,
+			"remove", &latte::ObservableList::remove,
+			"move", &latte::ObservableList::move,
+			"update", &latte::ObservableList::update,
+			"clear", &latte::ObservableList::clear,
+			"get", &latte::ObservableList::get,
+			"size", &latte::ObservableList::size,
+			sol::meta_function::length, &latte::ObservableList::size
+		);
+	}
+}
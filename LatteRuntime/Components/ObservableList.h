@@ -0,0 +1,83 @@
+#ifndef LATTE_OBSERVABLE_LIST_H
+#define LATTE_OBSERVABLE_LIST_H
+
+#include <sol/sol.hpp>
+#include <vector>
+#include <cstdint>
+
+namespace latte
+{
+	struct ComponentData;
+
+	enum ListChangeType : uint8_t
+	{
+		LIST_CHANGE_INSERT,		// count items were inserted at index
+		LIST_CHANGE_REMOVE,		// count items were removed from index
+		LIST_CHANGE_MOVE,		// The item at index moved to to
+		LIST_CHANGE_UPDATE		// count items starting at index have new values
+	};
+
+	/*
+		Indices are 0 based on the C++ side
+	*/
+	struct ListChange
+	{
+		ListChangeType type;
+		uint32_t index = 0;
+		uint32_t count = 1;
+		uint32_t to = 0;
+	};
+
+	/*
+		The object returned by latte.ObservableList.
+
+		Nodes with items = list and an itemBuilder have one child per item. Every edit is sent to those nodes
+		as a change record so only the affected children are built, removed or moved, the list is never diffed
+	*/
+	class ObservableList
+	{
+	public:
+
+		explicit ObservableList(sol::object initial);
+
+		// Lua facing, indices are 1 based
+		void insert(int index, sol::object value);
+		void push(sol::object value);
+		void remove(int index, sol::optional<int> count);
+		void move(int from, int to);
+		void update(int index, sol::object value);
+		void clear();
+		sol::object get(int index) const;
+
+		[[nodiscard]] size_t size() const noexcept { return m_Items.size(); }
+
+		[[nodiscard]] const sol::object& getValue(size_t index) const { return m_Items[index].value; }
+
+		/*
+			Stable for as long as the item is in the list, even when it moves
+		*/
+		[[nodiscard]] uint64_t getItemId(size_t index) const { return m_Items[index].id; }
+
+		void bind(ComponentData* host);
+		void unbind(ComponentData* host);
+
+		static void luaRegister(sol::state_view state);
+
+	private:
+
+		void emit(const ListChange& change);
+
+		struct Item
+		{
+			sol::object value;
+			uint64_t id;
+		};
+
+		std::vector<Item> m_Items;
+		uint64_t m_NextId = 1;
+
+		std::vector<ComponentData*> m_Hosts;
+	};
+}
+
+#endif // LATTE_OBSERVABLE_LIST_H
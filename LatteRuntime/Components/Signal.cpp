@@ -0,0 +1,56 @@
+#include "Signal.h"
+#include "Component.h"
+#include <format>
+
+namespace latte
+{
+	Signal::Signal(sol::object value) : m_Value(value)
+	{
+	}
+
+	void Signal::set(sol::object value)
+	{
+		sol::type type = value.get_type();
+		bool primitive = type == sol::type::lua_nil || type == sol::type::boolean || type == sol::type::number || type == sol::type::string;
+		if (primitive && m_Value.get_type() == type && m_Value == value)
+			return;
+
+		m_Value = value;
+
+		for (const Binding& binding : m_Bindings)
+			ComponentSystem::getInstance().patchSignalField(binding.data, binding.field, *this);
+	}
+
+	std::string Signal::getText() const
+	{
+		switch (m_Value.get_type())
+		{
+		case sol::type::string:
+			return m_Value.as<std::string>();
+		case sol::type::number:
+			return std::format("{}", m_Value.as<double>());
+		default:
+			return std::string();
+		}
+	}
+
+	void Signal::bind(ComponentData* data, SignalField field)
+	{
+		m_Bindings.push_back({ data, field });
+	}
+
+	void Signal::unbind(ComponentData* data)
+	{
+		std::erase_if(m_Bindings, [data](const Binding& binding) { return binding.data == data; });
+	}
+
+	void Signal::luaRegister(sol::state_view state)
+	{
+		state.new_usertype<latte::Signal>("Signal",
+			sol::no_constructor,
+			"get", &latte::Signal::get,
+			"set", &latte::Signal::set,
+			"value", sol::property(&latte::Signal::get, &latte::Signal::set)
+		);
+	}
+}
@@ -0,0 +1,70 @@
+#ifndef LATTE_SIGNAL_H
+#define LATTE_SIGNAL_H
+
+#include <sol/sol.hpp>
+#include <vector>
+#include <string>
+
+namespace latte
+{
+	struct ComponentData;
+
+	/*
+		Node fields a signal can be bound to by passing it as the property value
+	*/
+	enum SignalField : uint8_t
+	{
+		SIGNAL_FIELD_TEXT,				// text = sig
+		SIGNAL_FIELD_BACKGROUND_COLOR,	// style.backgroundColor = sig
+		SIGNAL_FIELD_COLOR,				// style.color = sig
+		SIGNAL_FIELD_BORDER_COLOR		// style.border.color = sig
+	};
+
+	/*
+		The object returned by latte.signal.
+
+		A signal passed as a property is bound to the node it ends up on. Setting it patches 
+		that node's field directly and only schedules a re-measure or repaint, no component is rebuilt
+	*/
+	class Signal
+	{
+	public:
+
+		explicit Signal(sol::object value);
+
+		[[nodiscard]] const sol::object& get() const noexcept { return m_Value; }
+
+		/*
+			Setting a primitive to the value it already has does nothing
+		*/
+		void set(sol::object value);
+
+		/*
+			The value as text, numbers are formatted and anything else is an empty string
+		*/
+		[[nodiscard]] std::string getText() const;
+
+		void bind(ComponentData* data, SignalField field);
+
+		/*
+			Removes every binding to the node
+		*/
+		void unbind(ComponentData* data);
+
+		static void luaRegister(sol::state_view state);
+
+	private:
+
+		struct Binding
+		{
+			ComponentData* data;
+			SignalField field;
+		};
+
+		sol::object m_Value;
+
+		std::vector<Binding> m_Bindings;
+	};
+}
+
+#endif // LATTE_SIGNAL_H
@@ -0,0 +1,121 @@
+#include "State.h"
+#include "Component.h"
+#include <algorithm>
+
+namespace latte
+{
+	static bool isPrimitive(sol::type type)
+	{
+		return type == sol::type::lua_nil || type == sol::type::boolean ||
+			type == sol::type::number || type == sol::type::string;
+	}
+
+	State::State(sol::table values, LatteNode* owner) : m_Values(values), m_Owner(owner)
+	{
+	}
+
+	sol::object State::get(sol::stack_object key)
+	{
+		// Only reads made while building a component are dependencies,
+		// event handlers read state too but that shouldn't cause a rebuild
+		LatteNode* node = ComponentSystem::getInstance().getCurrentNode();
+		if (node == m_Owner && node != nullptr)
+		{
+			m_OwnerReads.record(key);
+		}
+		else if (ComponentData* reader = node ? (ComponentData*)latteGetUserData(node) : nullptr)
+		{
+			// Handed down to another component, that one rebuilds when it changes instead of the owner
+			auto [itr, inserted] = m_Readers.try_emplace(reader);
+			if (inserted)
+				reader->stateReads.push_back(weak_from_this());
+
+			itr->second.record(key);
+		}
+
+		return m_Values.raw_get<sol::object>(key);
+	}
+
+	void State::set(sol::stack_object key, sol::stack_object value)
+	{
+		sol::object changed = key;
+		if (assign(changed, value))
+			markReadersDirty({ changed }, false);
+	}
+
+	void State::setState(sol::table newState)
+	{
+		std::vector<sol::object> changed;
+
+		for (const auto& kv : newState)
+		{
+			if (assign(kv.first, kv.second))
+				changed.push_back(kv.first);
+		}
+
+		markReadersDirty(changed, newState.empty());
+	}
+
+	void State::beginRender()
+	{
+		m_OwnerReads = ReadSet();
+	}
+
+	bool State::assign(const sol::object& key, const sol::object& value)
+	{
+		sol::object current = m_Values.raw_get<sol::object>(key);
+
+		if (current.get_type() == value.get_type() && isPrimitive(value.get_type()) && current == value)
+			return false;
+
+		m_Values.raw_set(key, value);
+		return true;
+	}
+
+	void State::markReadersDirty(const std::vector<sol::object>& keys, bool forceOwner)
+	{
+		auto readAny = [&](const ReadSet& reads) {
+			return std::any_of(keys.begin(), keys.end(),
+				[&](const sol::object& key) { return reads.dependsOn(key); });
+			};
+
+		ComponentSystem& system = ComponentSystem::getInstance();
+
+		// Only the components that read a changed key get rebuilt
+		if (m_Owner && (forceOwner || readAny(m_OwnerReads)))
+			system.markDirty(m_Owner);
+
+		for (const auto& [reader, reads] : m_Readers)
+		{
+			if (readAny(reads))
+				system.markDirty(reader->node);
+		}
+	}
+
+	void State::ReadSet::record(const sol::object& key)
+	{
+		if (key.get_type() == sol::type::string)
+			keys.insert(key.as<std::string>());
+		else
+			untracked = true;
+	}
+
+	bool State::ReadSet::dependsOn(const sol::object& key) const
+	{
+		if (untracked || key.get_type() != sol::type::string)
+			return true;
+
+		return keys.contains(key.as<std::string>());
+	}
+
+	void State::luaRegister(sol::state_view state)
+	{
+		// Named members are found first, anything else goes through get/set to the values
+		state.new_usertype<latte::State>("State",
+			sol::no_constructor,
+			"setState", &latte::State::setState,
+			sol::meta_function::index, &latte::State::get,
+			sol::meta_function::new_index, &latte::State::set
+		);
+	}
+}
@@ -0,0 +1,90 @@
+#ifndef LATTE_STATE_H
+#define LATTE_STATE_H
+
+#include <sol/sol.hpp>
+extern "C" {
+#include <LatteLayout/layout.h>
+}
+#include <string>
+#include <unordered_set>
+#include <unordered_map>
+#include <vector>
+#include <memory>
+
+namespace latte
+{
+	struct ComponentData;
+
+	/*
+		The object returned by latte.useState.
+
+		Reads made while a component is being built are recorded per key, so a write only
+		rebuilds the owning component when the render actually depended on that key.
+		Other components can be handed the state and read it too, they are tracked separately
+		and rebuilt themselves rather than crediting their reads to the owner.
+		Writing a primitive value that is already stored is a no-op. Tables and functions
+		can be mutated in place so writing one always counts as a change
+	*/
+	class State : public std::enable_shared_from_this<State>
+	{
+	public:
+
+		State(sol::table values, LatteNode* owner);
+
+		// state.key
+		sol::object get(sol::stack_object key);
+
+		// state.key = value
+		void set(sol::stack_object key, sol::stack_object value);
+
+		/*
+			Sets every key in the table, an empty table forces the owner to rebuild
+		*/
+		void setState(sol::table newState);
+
+		/*
+			Called before the owner is built, forgets which keys the last build read
+		*/
+		void beginRender();
+
+		/*
+			The owning node is being freed, writes after this only update the values
+		*/
+		void detach() noexcept { m_Owner = nullptr; }
+
+		/*
+			Forgets what a component other than the owner read, called when it is rebuilt or freed
+		*/
+		void removeReader(ComponentData* reader) { m_Readers.erase(reader); }
+
+		static void luaRegister(sol::state_view state);
+
+	private:
+
+		struct ReadSet
+		{
+			std::unordered_set<std::string> keys;
+
+			// A non-string key was read, we can't track those so any change counts
+			bool untracked = false;
+
+			void record(const sol::object& key);
+			[[nodiscard]] bool dependsOn(const sol::object& key) const;
+		};
+
+		// Returns true if the stored value changed
+		bool assign(const sol::object& key, const sol::object& value);
+
+		// Rebuilds the owner and every reader whose last build read one of the keys
+		void markReadersDirty(const std::vector<sol::object>& keys, bool forceOwner);
+
+		sol::table m_Values;
+
+		LatteNode* m_Owner = nullptr;
+
+		ReadSet m_OwnerReads;
+		std::unordered_map<ComponentData*, ReadSet> m_Readers;
+	};
+}
+
+#endif // LATTE_STATE_H
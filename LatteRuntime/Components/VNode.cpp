@@ -0,0 +1,526 @@
+#include "VNode.h"
+#include "../Utils/Hash.h"
+#include <array>
+#include <bit>
+#include <cstring>
+
+namespace latte
+{
+	enum VNodeProp
+	{
+		VNODE_PROP_ID,
+		VNODE_PROP_COMPONENT_TYPE,
+		VNODE_PROP_ORIGINAL_PROPS,
+		VNODE_PROP_MEMO,
+		VNODE_PROP_CHILDREN,
+		VNODE_PROP_STYLE,
+		VNODE_PROP_PADDING,
+		VNODE_PROP_SIZE,
+		VNODE_PROP_SPACING,
+		VNODE_PROP_MAIN_AXIS_ALIGNMENT,
+		VNODE_PROP_CROSS_AXIS_ALIGNMENT,
+		VNODE_PROP_DIRECTION,
+		VNODE_PROP_LAYOUT,
+		VNODE_PROP_POSITION,
+		VNODE_PROP_TEXT,
+		VNODE_PROP_STATIC,
+		VNODE_PROP_ITEMS,
+		VNODE_PROP_ITEM_BUILDER,
+		VNODE_PROP_EVENT,
+
+		// Not a key, only mixed into fingerprints for bound signals
+		VNODE_PROP_SIGNAL
+	};
+
+	struct VNodePropInfo
+	{
+		VNodeProp prop;
+
+		// Only for VNODE_PROP_EVENT
+		ComponentEvent event = COMPONENT_EVENT_PAINT;
+	};
+
+	struct VNodePropKey
+	{
+		std::string_view name;
+		VNodePropInfo info;
+	};
+
+	// Every key the reconciler understands, anything else in a table is skipped
+	static constexpr VNodePropKey s_PropKeys[] = {
+		{ "id", { VNODE_PROP_ID } },
+		{ "component_type", { VNODE_PROP_COMPONENT_TYPE } },
+		{ "original_props", { VNODE_PROP_ORIGINAL_PROPS } },
+		{ "memo", { VNODE_PROP_MEMO } },
+		{ "children", { VNODE_PROP_CHILDREN } },
+		{ "style", { VNODE_PROP_STYLE } },
+		{ "padding", { VNODE_PROP_PADDING } },
+		{ "size", { VNODE_PROP_SIZE } },
+		{ "spacing", { VNODE_PROP_SPACING } },
+		{ "mainAxisAlignment", { VNODE_PROP_MAIN_AXIS_ALIGNMENT } },
+		{ "crossAxisAlignment", { VNODE_PROP_CROSS_AXIS_ALIGNMENT } },
+		{ "direction", { VNODE_PROP_DIRECTION } },
+		{ "layout", { VNODE_PROP_LAYOUT } },
+		{ "position", { VNODE_PROP_POSITION } },
+		{ "text", { VNODE_PROP_TEXT } },
+		{ "__latte_static", { VNODE_PROP_STATIC } },
+		{ "items", { VNODE_PROP_ITEMS } },
+		{ "itemBuilder", { VNODE_PROP_ITEM_BUILDER } },
+		{ "onPaint", { VNODE_PROP_EVENT, COMPONENT_EVENT_PAINT } },
+		{ "onHoverEnter", { VNODE_PROP_EVENT, COMPONENT_EVENT_HOVER_ENTER } },
+		{ "onHoverExit", { VNODE_PROP_EVENT, COMPONENT_EVENT_HOVER_EXIT } },
+		{ "onClick", { VNODE_PROP_EVENT, COMPONENT_EVENT_CLICK } },
+		{ "onKeyDown", { VNODE_PROP_EVENT, COMPONENT_EVENT_KEY_DOWN } },
+		{ "onTextInput", { VNODE_PROP_EVENT, COMPONENT_EVENT_TEXT_INPUT } }
+	};
+
+	/*
+		Perfect hash over s_PropKeys, the constants were searched for so that every key gets its own slot.
+		A key from Lua is looked up with one slot read and one compare, anything unknown fails the compare
+	*/
+	constexpr size_t PROP_SLOT_COUNT = 64;
+
+	static constexpr size_t hashPropKey(const char* key, size_t length)
+	{
+		return (length + (uint8_t)key[0] + (uint8_t)key[length / 2] * 4 + (uint8_t)key[length - 1] * 23) & (PROP_SLOT_COUNT - 1);
+	}
+
+	static constexpr std::array<int8_t, PROP_SLOT_COUNT> buildPropSlots()
+	{
+		std::array<int8_t, PROP_SLOT_COUNT> slots{};
+		slots.fill(-1);
+
+		for (size_t i = 0; i < std::size(s_PropKeys); i++)
+			slots[hashPropKey(s_PropKeys[i].name.data(), s_PropKeys[i].name.size())] = (int8_t)i;
+
+		return slots;
+	}
+
+	static constexpr std::array<int8_t, PROP_SLOT_COUNT> s_PropSlots = buildPropSlots();
+
+	static constexpr bool propSlotsArePerfect()
+	{
+		for (size_t i = 0; i < std::size(s_PropKeys); i++)
+		{
+			if (s_PropSlots[hashPropKey(s_PropKeys[i].name.data(), s_PropKeys[i].name.size())] != (int8_t)i)
+				return false;
+		}
+
+		return true;
+	}
+
+	static_assert(propSlotsArePerfect(), "Two prop keys share a slot, hashPropKey needs new constants");
+
+	static const VNodePropInfo* findProp(const char* key, size_t length)
+	{
+		if (length == 0)
+			return nullptr;
+
+		int8_t slot = s_PropSlots[hashPropKey(key, length)];
+		if (slot < 0)
+			return nullptr;
+
+		const VNodePropKey& prop = s_PropKeys[slot];
+		if (prop.name.size() != length || memcmp(prop.name.data(), key, length) != 0)
+			return nullptr;
+
+		return &prop.info;
+	}
+
+	// Reads t[n] from the table at an absolute stack index
+	static float rawGetFloat(lua_State* L, int table, int n, float fallback)
+	{
+		lua_rawgeti(L, table, n);
+		float value = lua_type(L, -1) == LUA_TNUMBER ? (float)lua_tonumber(L, -1) : fallback;
+		lua_pop(L, 1);
+		return value;
+	}
+
+	// Fingerprints add the hash of each property so the order a table is walked in doesn't matter
+	static uint64_t mixProp(VNodeProp prop, uint64_t value)
+	{
+		return hashCombine((uint64_t)prop + 1, value);
+	}
+
+	/*
+		Children are summed in lua_next order, so each term carries its position twice: hashed in, then
+		rotated and scaled (odd, so nothing is lost) by it. Siblings that trade places change the sum
+	*/
+	static uint64_t mixChild(int position, uint64_t fingerprint)
+	{
+		const uint64_t index = (uint64_t)position;
+		return std::rotl(mixProp(VNODE_PROP_CHILDREN, hashCombine(index, fingerprint)), (int)(index & 63)) * (index * 2 + 1);
+	}
+
+	static uint64_t hashFloat(float value)
+	{
+		return std::bit_cast<uint32_t>(value);
+	}
+
+	uint32_t VNodeBuffer::build(sol::table table)
+	{
+		uint32_t index = (uint32_t)m_Nodes.size();
+		m_Nodes.emplace_back();
+
+		convert(index, table, 0);
+
+		return index;
+	}
+
+	void VNodeBuffer::clear()
+	{
+		m_Nodes.clear();
+		m_Strings.clear();
+		m_Tables.clear();
+		m_Handlers.clear();
+		m_Signals.clear();
+		m_Lists.clear();
+	}
+
+	uint32_t VNodeBuffer::pushString(std::string_view str)
+	{
+		uint32_t offset = (uint32_t)m_Strings.size();
+		m_Strings.insert(m_Strings.end(), str.begin(), str.end());
+		return offset;
+	}
+
+	void VNodeBuffer::convert(uint32_t index, sol::table table, int childIndex)
+	{
+		VNode node;
+		node.childIndex = childIndex;
+		node.firstHandler = (uint32_t)m_Handlers.size();
+		node.firstSignal = (uint32_t)m_Signals.size();
+
+		sol::table childrenTable;
+		sol::table props;
+
+		std::shared_ptr<ObservableList> items;
+		sol::protected_function itemBuilder;
+
+		uint64_t fingerprint = 0;
+		bool dynamic = false;
+
+		// One lua_next walk over the table, values are read straight off the stack
+		// and only wrapped in sol references when they need to outlive the walk
+		lua_State* L = table.lua_state();
+		table.push();
+		const int tableIndex = lua_gettop(L);
+
+		lua_pushnil(L);
+		while (lua_next(L, tableIndex) != 0)
+		{
+			// lua_tolstring would convert a number key in place and break lua_next, so only strings are read
+			const VNodePropInfo* info = nullptr;
+			if (lua_type(L, -2) == LUA_TSTRING)
+			{
+				size_t keyLength = 0;
+				const char* key = lua_tolstring(L, -2, &keyLength);
+				info = findProp(key, keyLength);
+			}
+
+			if (info == nullptr)
+			{
+				lua_pop(L, 1);
+				continue;
+			}
+
+			const int valueIndex = lua_gettop(L);
+			const int type = lua_type(L, valueIndex);
+
+			switch (info->prop)
+			{
+			case VNODE_PROP_ID:
+				if (type == LUA_TSTRING)
+				{
+					size_t length = 0;
+					const char* str = lua_tolstring(L, valueIndex, &length);
+					std::string_view key(str, length);
+					node.flags |= VNODE_FLAG_KEYED;
+					node.keyHash = hashString(key);
+					node.key = pushString(key);
+					node.keyLength = (uint32_t)key.size();
+					fingerprint += mixProp(VNODE_PROP_ID, node.keyHash);
+				}
+				break;
+			case VNODE_PROP_COMPONENT_TYPE:
+				if (type == LUA_TNUMBER)
+				{
+					node.kind = VNODE_COMPONENT;
+					node.componentType = (ComponentTypeId)lua_tointeger(L, valueIndex);
+				}
+				break;
+			case VNODE_PROP_ORIGINAL_PROPS:
+				if (type == LUA_TTABLE)
+					props = sol::table(L, valueIndex);
+				break;
+			case VNODE_PROP_MEMO:
+				if (type == LUA_TBOOLEAN && lua_toboolean(L, valueIndex))
+					node.flags |= VNODE_FLAG_MEMO;
+				break;
+			case VNODE_PROP_CHILDREN:
+				if (type == LUA_TTABLE)
+				{
+					childrenTable = sol::table(L, valueIndex);
+					node.flags |= VNODE_FLAG_CHILDREN;
+				}
+				break;
+			case VNODE_PROP_STYLE:
+				if (type == LUA_TTABLE)
+				{
+					StyleSignals signals;
+					node.style = resolveStyle(L, valueIndex, &signals);
+					node.flags |= VNODE_FLAG_STYLE;
+					fingerprint += mixProp(VNODE_PROP_STYLE, hashStyle(node.style));
+
+					if (signals.backgroundColor)
+						m_Signals.push_back({ SIGNAL_FIELD_BACKGROUND_COLOR, signals.backgroundColor });
+					if (signals.color)
+						m_Signals.push_back({ SIGNAL_FIELD_COLOR, signals.color });
+					if (signals.borderColor)
+						m_Signals.push_back({ SIGNAL_FIELD_BORDER_COLOR, signals.borderColor });
+				}
+				break;
+			case VNODE_PROP_PADDING:
+				if (type == LUA_TTABLE)
+				{
+					uint64_t hash = 0;
+					for (int i = 0; i < 4; i++)
+					{
+						node.padding[i] = rawGetFloat(L, valueIndex, i + 1, 0.0f);
+						hash = hashCombine(hash, hashFloat(node.padding[i]));
+					}
+					node.flags |= VNODE_FLAG_PADDING;
+					fingerprint += mixProp(VNODE_PROP_PADDING, hash);
+				}
+				break;
+			case VNODE_PROP_SIZE:
+				if (type == LUA_TTABLE)
+				{
+					node.size[0] = rawGetFloat(L, valueIndex, 1, 0.0f);
+					node.size[1] = rawGetFloat(L, valueIndex, 2, 0.0f);
+					node.flags |= VNODE_FLAG_SIZE;
+					fingerprint += mixProp(VNODE_PROP_SIZE, hashCombine(hashFloat(node.size[0]), hashFloat(node.size[1])));
+				}
+				break;
+			case VNODE_PROP_SPACING:
+				if (type == LUA_TNUMBER)
+				{
+					node.spacing = (float)lua_tonumber(L, valueIndex);
+					fingerprint += mixProp(VNODE_PROP_SPACING, hashFloat(node.spacing));
+				}
+				break;
+			case VNODE_PROP_MAIN_AXIS_ALIGNMENT:
+				if (type == LUA_TNUMBER)
+				{
+					node.mainAxisAlignment = (LatteContentAlignment)lua_tointeger(L, valueIndex);
+					fingerprint += mixProp(VNODE_PROP_MAIN_AXIS_ALIGNMENT, (uint64_t)node.mainAxisAlignment);
+				}
+				break;
+			case VNODE_PROP_CROSS_AXIS_ALIGNMENT:
+				if (type == LUA_TNUMBER)
+				{
+					node.crossAxisAlignment = (LatteContentAlignment)lua_tointeger(L, valueIndex);
+					fingerprint += mixProp(VNODE_PROP_CROSS_AXIS_ALIGNMENT, (uint64_t)node.crossAxisAlignment);
+				}
+				break;
+			case VNODE_PROP_DIRECTION:
+				if (type == LUA_TSTRING)
+				{
+					size_t length = 0;
+					const char* str = lua_tolstring(L, valueIndex, &length);
+					std::string_view dir(str, length);
+					fingerprint += mixProp(VNODE_PROP_DIRECTION, hashString(dir));
+					if (dir == "horizontal")
+					{
+						node.direction = LATTE_DIRECTION_HORIZONTAL;
+						node.flags |= VNODE_FLAG_DIRECTION;
+					}
+					else if (dir == "vertical")
+					{
+						node.direction = LATTE_DIRECTION_VERTICAL;
+						node.flags |= VNODE_FLAG_DIRECTION;
+					}
+				}
+				break;
+			case VNODE_PROP_LAYOUT:
+				if (type == LUA_TNUMBER && lua_tointeger(L, valueIndex) == LATTE_POSITIONER_ABSOLUTE)
+				{
+					node.flags |= VNODE_FLAG_ABSOLUTE;
+					fingerprint += mixProp(VNODE_PROP_LAYOUT, LATTE_POSITIONER_ABSOLUTE);
+				}
+				break;
+			case VNODE_PROP_POSITION:
+				if (type == LUA_TTABLE)
+				{
+					node.position[0] = rawGetFloat(L, valueIndex, 1, 0.0f);
+					node.position[1] = rawGetFloat(L, valueIndex, 2, 0.0f);
+					fingerprint += mixProp(VNODE_PROP_POSITION, hashCombine(hashFloat(node.position[0]), hashFloat(node.position[1])));
+				}
+				break;
+			case VNODE_PROP_TEXT:
+				if (type == LUA_TSTRING || type == LUA_TNUMBER)
+				{
+					// Converted on a copy, lua_tolstring turns a number into a string in place
+					lua_pushvalue(L, valueIndex);
+					size_t length = 0;
+					const char* str = lua_tolstring(L, -1, &length);
+					std::string_view text(str, length);
+					node.text = pushString(text);
+					node.textLength = (uint32_t)text.size();
+					node.flags |= VNODE_FLAG_TEXT;
+					fingerprint += mixProp(VNODE_PROP_TEXT, hashString(text));
+					lua_pop(L, 1);
+				}
+				else if (type == LUA_TUSERDATA)
+				{
+					sol::stack_object value(L, valueIndex);
+					if (value.is<std::shared_ptr<Signal>>())
+					{
+						std::shared_ptr<Signal> signal = value.as<std::shared_ptr<Signal>>();
+						std::string text = signal->getText();
+						node.text = pushString(text);
+						node.textLength = (uint32_t)text.size();
+						node.flags |= VNODE_FLAG_TEXT;
+						m_Signals.push_back({ SIGNAL_FIELD_TEXT, std::move(signal) });
+					}
+				}
+				break;
+			case VNODE_PROP_STATIC:
+				if (type == LUA_TBOOLEAN && lua_toboolean(L, valueIndex))
+					node.flags |= VNODE_FLAG_STATIC;
+				break;
+			case VNODE_PROP_ITEMS:
+				if (type == LUA_TUSERDATA)
+				{
+					sol::stack_object value(L, valueIndex);
+					if (value.is<std::shared_ptr<ObservableList>>())
+						items = value.as<std::shared_ptr<ObservableList>>();
+				}
+				break;
+			case VNODE_PROP_ITEM_BUILDER:
+				if (type == LUA_TFUNCTION)
+					itemBuilder = sol::protected_function(L, valueIndex);
+				break;
+			case VNODE_PROP_EVENT:
+				if (type == LUA_TFUNCTION)
+				{
+					m_Handlers.push_back({ info->event, sol::protected_function(L, valueIndex) });
+					dynamic = true;
+				}
+				break;
+			default:
+				break;
+			}
+
+			lua_pop(L, 1);
+		}
+
+		// The table itself
+		lua_pop(L, 1);
+
+		node.handlerCount = (uint32_t)m_Handlers.size() - node.firstHandler;
+		node.signalCount = (uint32_t)m_Signals.size() - node.firstSignal;
+
+		// Bound values change without a rebuild, so the signals themselves are what identify the node's content
+		for (uint32_t i = node.firstSignal; i < m_Signals.size(); i++)
+		{
+			const VNodeSignal& bound = m_Signals[i];
+			fingerprint += mixProp(VNODE_PROP_SIGNAL, hashCombine(bound.field, (uint64_t)(uintptr_t)bound.signal.get()));
+		}
+
+		// The list owns the children, and the builder is usually a new closure each build so it is always reapplied
+		if (items && itemBuilder.valid())
+		{
+			node.flags |= VNODE_FLAG_LIST;
+			node.flags &= ~VNODE_FLAG_CHILDREN;
+			node.list = (uint32_t)m_Lists.size();
+			m_Lists.push_back({ std::move(items), std::move(itemBuilder) });
+			dynamic = true;
+		}
+
+		if (node.kind == VNODE_COMPONENT)
+		{
+			if (props.valid() && props.get_or("memo", false))
+				node.flags |= VNODE_FLAG_MEMO;
+
+			node.props = (uint32_t)m_Tables.size();
+			m_Tables.push_back(props);
+
+			// A component's children belong to its props, they are converted when it is built
+			node.flags &= ~(VNODE_FLAG_CHILDREN | VNODE_FLAG_STATIC);
+			m_Nodes[index] = node;
+			return;
+		}
+
+		// Reserve a contiguous range for the children before converting any of them
+		std::vector<std::pair<int, sol::table>> children;
+		if (node.flags & VNODE_FLAG_CHILDREN)
+		{
+			childrenTable.push();
+			const int childrenIndex = lua_gettop(L);
+
+			lua_pushnil(L);
+			while (lua_next(L, childrenIndex) != 0)
+			{
+				if (lua_type(L, -1) == LUA_TTABLE && lua_type(L, -2) == LUA_TNUMBER)
+					children.emplace_back((int)lua_tointeger(L, -2), sol::table(L, -1));
+
+				lua_pop(L, 1);
+			}
+
+			lua_pop(L, 1);
+		}
+
+		node.firstChild = (uint32_t)m_Nodes.size();
+		node.childCount = (uint32_t)children.size();
+		m_Nodes.resize(m_Nodes.size() + children.size());
+
+		for (uint32_t i = 0; i < children.size(); i++)
+		{
+			uint32_t childIndex = node.firstChild + i;
+			const sol::table& childTable = children[i].second;
+
+			// Static tables that are already mounted somewhere are never read again
+			const ComponentSystem::FrozenTable* frozen = ComponentSystem::getInstance().findFrozenTable(childTable.pointer());
+			if (frozen)
+			{
+				VNode& child = m_Nodes[childIndex];
+				child.flags = VNODE_FLAG_FROZEN | (frozen->keyed ? VNODE_FLAG_KEYED : VNODE_FLAG_NONE);
+				child.childIndex = children[i].first;
+				child.keyHash = frozen->keyHash;
+				child.fingerprint = frozen->fingerprint;
+				child.source = (uint32_t)m_Tables.size();
+				m_Tables.push_back(childTable);
+			}
+			else
+			{
+				convert(childIndex, childTable, children[i].first);
+			}
+
+			const VNode& child = m_Nodes[childIndex];
+			if (child.fingerprint == 0)
+				dynamic = true;
+			else
+				fingerprint += mixChild(child.childIndex, child.fingerprint);
+		}
+
+		if (!dynamic)
+			node.fingerprint = fingerprint != 0 ? fingerprint : 1;
+
+		if (node.flags & VNODE_FLAG_STATIC)
+		{
+			if (dynamic)
+			{
+				// Can't freeze something with callbacks or components in it
+				node.flags &= ~VNODE_FLAG_STATIC;
+			}
+			else
+			{
+				node.source = (uint32_t)m_Tables.size();
+				m_Tables.push_back(table);
+			}
+		}
+
+		m_Nodes[index] = node;
+	}
+}
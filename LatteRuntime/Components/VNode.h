@@ -0,0 +1,165 @@
+#ifndef LATTE_VNODE_H
+#define LATTE_VNODE_H
+
+#include <sol/sol.hpp>
+extern "C" {
+#include <LatteLayout/layout.h>
+}
+#include <vector>
+#include <string_view>
+#include "Component.h"
+#include "../Rendering/ResolvedStyle.h"
+#include "Signal.h"
+#include "ObservableList.h"
+#include <memory>
+
+namespace latte
+{
+	enum VNodeKind : uint8_t
+	{
+		VNODE_ELEMENT,		// A plain table of properties, applied straight to a node
+		VNODE_COMPONENT		// A component descriptor, built later as its own unit of work or inline when it is a component's root
+	};
+
+	enum VNodeFlags : uint32_t
+	{
+		VNODE_FLAG_NONE = 0,
+		VNODE_FLAG_KEYED = 1 << 0,		// Has a user id
+		VNODE_FLAG_CHILDREN = 1 << 1,	// Had a children table, even an empty one removes existing children
+		VNODE_FLAG_STYLE = 1 << 2,
+		VNODE_FLAG_PADDING = 1 << 3,
+		VNODE_FLAG_SIZE = 1 << 4,
+		VNODE_FLAG_DIRECTION = 1 << 5,
+		VNODE_FLAG_ABSOLUTE = 1 << 6,	// layout = absolute, position is valid
+		VNODE_FLAG_TEXT = 1 << 7,
+		VNODE_FLAG_MEMO = 1 << 8,
+		VNODE_FLAG_STATIC = 1 << 9,		// Marked with latte.static, frozen once it is mounted
+		VNODE_FLAG_FROZEN = 1 << 10,	// An already mounted static table, only the fingerprint and key are known
+		VNODE_FLAG_LIST = 1 << 11		// Children come from an ObservableList, children is ignored
+	};
+
+	struct VNodeHandler
+	{
+		ComponentEvent event;
+		sol::protected_function func;
+	};
+
+	struct VNodeList
+	{
+		std::shared_ptr<ObservableList> items;
+		sol::protected_function itemBuilder;
+	};
+
+	struct VNodeSignal
+	{
+		SignalField field;
+		std::shared_ptr<Signal> signal;
+	};
+
+	/*
+		One table from a component's output with every property the reconciler uses read out of Lua.
+		Strings, handlers and props live in the owning VNodeBuffer and are referenced by index
+	*/
+	struct VNode
+	{
+		VNodeKind kind = VNODE_ELEMENT;
+		uint32_t flags = VNODE_FLAG_NONE;
+
+		// Position in the parent's children table, and the user id when keyed
+		int childIndex = 0;
+		uint64_t keyHash = 0;
+		uint32_t key = 0;
+		uint32_t keyLength = 0;
+
+		// Children are stored contiguously in the buffer
+		uint32_t firstChild = 0;
+		uint32_t childCount = 0;
+
+		// Hash of everything the reconciler reads from this subtree,
+		// 0 when it has handlers or components in it and so can't be skipped
+		uint64_t fingerprint = 0;
+
+		// The source table for static and frozen vnodes, index into the buffer's tables
+		uint32_t source = 0;
+
+		// Components
+		ComponentTypeId componentType = COMPONENT_TYPE_NONE;
+		uint32_t props = 0;
+
+		// Elements
+		float padding[4] = { 0.0f, 0.0f, 0.0f, 0.0f }; // Left, top, right, bottom
+		float size[2] = { 0.0f, 0.0f };
+		float position[2] = { 0.0f, 0.0f };
+		float spacing = 0.0f;
+		LatteContentAlignment mainAxisAlignment = LATTE_CONTENT_START;
+		LatteContentAlignment crossAxisAlignment = LATTE_CONTENT_START;
+		LatteLayoutDirection direction = LATTE_DIRECTION_HORIZONTAL;
+
+		ResolvedStyle style;
+
+		uint32_t text = 0;
+		uint32_t textLength = 0;
+
+		uint32_t firstHandler = 0;
+		uint32_t handlerCount = 0;
+
+		// Signals passed as property values, the node is bound to them when applied
+		uint32_t firstSignal = 0;
+		uint32_t signalCount = 0;
+
+		// items and itemBuilder, index into the buffer's lists
+		uint32_t list = 0;
+	};
+
+	/*
+		A flat buffer of vnodes converted from the table a component returns.
+
+		Each table is walked once, conversion stops at component descriptors since those are built separately.
+		The buffer is cleared and reused between builds so its storage is only allocated once
+	*/
+	class VNodeBuffer
+	{
+	public:
+
+		/*
+			Converts a table and its children, returns the index of the vnode for the table itself
+		*/
+		uint32_t build(sol::table table);
+
+		void clear();
+
+		[[nodiscard]] const VNode& get(uint32_t index) const { return m_Nodes[index]; }
+
+		[[nodiscard]] std::string_view getString(uint32_t offset, uint32_t length) const
+		{
+			return std::string_view(m_Strings.data() + offset, length);
+		}
+
+		[[nodiscard]] std::string_view getKey(const VNode& node) const { return getString(node.key, node.keyLength); }
+		[[nodiscard]] std::string_view getText(const VNode& node) const { return getString(node.text, node.textLength); }
+
+		[[nodiscard]] const sol::table& getProps(const VNode& node) const { return m_Tables[node.props]; }
+		[[nodiscard]] const sol::table& getSource(const VNode& node) const { return m_Tables[node.source]; }
+
+		[[nodiscard]] const VNodeHandler* getHandlers(const VNode& node) const { return m_Handlers.data() + node.firstHandler; }
+		[[nodiscard]] const VNodeSignal* getSignals(const VNode& node) const { return m_Signals.data() + node.firstSignal; }
+		[[nodiscard]] const VNodeList& getList(const VNode& node) const { return m_Lists[node.list]; }
+
+	private:
+
+		void convert(uint32_t index, sol::table table, int childIndex);
+
+		uint32_t pushString(std::string_view str);
+
+		std::vector<VNode> m_Nodes;
+		std::vector<char> m_Strings;
+
+		// Component props and static sources
+		std::vector<sol::table> m_Tables;
+		std::vector<VNodeHandler> m_Handlers;
+		std::vector<VNodeSignal> m_Signals;
+		std::vector<VNodeList> m_Lists;
+	};
+}
+
+#endif // LATTE_VNODE_H
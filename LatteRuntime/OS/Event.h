@@ -5,7 +5,6 @@
 #include <variant>
 #include <cstdint>
 #include <string>
-#include <vector>
 
 namespace latte
 {
@@ -28,11 +27,26 @@ namespace latte
 		int dx, dy;
 	};
 
+	enum KeyMod : uint16_t
+	{
+		KEY_MOD_NONE = 0,
+		KEY_MOD_LEFT_SHIFT = 1 << 0,
+		KEY_MOD_RIGHT_SHIFT = 1 << 1,
+		KEY_MOD_LEFT_CTRL = 1 << 2,
+		KEY_MOD_RIGHT_CTRL = 1 << 3,
+		KEY_MOD_LEFT_ALT = 1 << 4,
+		KEY_MOD_RIGHT_ALT = 1 << 5,
+		KEY_MOD_LEFT_GUI = 1 << 6,
+		KEY_MOD_RIGHT_GUI = 1 << 7
+	};
+
 	struct KeyDownEvent
 	{
 		int keyCode;
 		std::string name;
-		std::vector<std::string> keyMods;
+
+		// KeyMod flags held when the key was pressed
+		uint16_t keyMods;
 	};
 
 	struct MouseButtonEvent
@@ -2,28 +2,43 @@
 #include "../Rendering/NodeRenderer.h"
 #include "../Components/ComponentEvents.h"
 #include "../Components/Component.h"
+#include "../Utils/FrameArena.h"
 
 namespace latte
 {
 	Uint32 engine_event_type_base;
 
-	std::vector<std::string> getKeyModNames(SDL_Keymod mod) 
+	uint16_t getKeyMods(SDL_Keymod mod) 
 	{
-		std::vector<std::string> mods;
-		if (mod & SDL_KMOD_LCTRL)  mods.push_back("left ctrl");
-		if (mod & SDL_KMOD_RCTRL)  mods.push_back("right ctrl");
-		if (mod & SDL_KMOD_LSHIFT) mods.push_back("left shift");
-		if (mod & SDL_KMOD_RSHIFT) mods.push_back("right shift");
-		if (mod & SDL_KMOD_LALT)   mods.push_back("left alt");
-		if (mod & SDL_KMOD_RALT)   mods.push_back("right alt");
-		if (mod & SDL_KMOD_LGUI)   mods.push_back("left gui");
-		if (mod & SDL_KMOD_RGUI)   mods.push_back("right gui");
-		/*if (mod & SDL_KMOD_NUM)    mods.push_back("num");
-		if (mod & SDL_KMOD_CAPS)   mods.push_back("caps");
-		if (mod & SDL_KMOD_MODE)   mods.push_back("mode");*/
+		uint16_t mods = KEY_MOD_NONE;
+		if (mod & SDL_KMOD_LCTRL)  mods |= KEY_MOD_LEFT_CTRL;
+		if (mod & SDL_KMOD_RCTRL)  mods |= KEY_MOD_RIGHT_CTRL;
+		if (mod & SDL_KMOD_LSHIFT) mods |= KEY_MOD_LEFT_SHIFT;
+		if (mod & SDL_KMOD_RSHIFT) mods |= KEY_MOD_RIGHT_SHIFT;
+		if (mod & SDL_KMOD_LALT)   mods |= KEY_MOD_LEFT_ALT;
+		if (mod & SDL_KMOD_RALT)   mods |= KEY_MOD_RIGHT_ALT;
+		if (mod & SDL_KMOD_LGUI)   mods |= KEY_MOD_LEFT_GUI;
+		if (mod & SDL_KMOD_RGUI)   mods |= KEY_MOD_RIGHT_GUI;
 		return mods;
 	}
 
+	static bool isInputEvent(Uint32 type)
+	{
+		switch (type)
+		{
+		case SDL_EVENT_KEY_DOWN:
+		case SDL_EVENT_KEY_UP:
+		case SDL_EVENT_TEXT_INPUT:
+		case SDL_EVENT_MOUSE_MOTION:
+		case SDL_EVENT_MOUSE_BUTTON_DOWN:
+		case SDL_EVENT_MOUSE_BUTTON_UP:
+		case SDL_EVENT_MOUSE_WHEEL:
+			return true;
+		default:
+			return false;
+		}
+	}
+
 	void EventLoop::runEventLoop(sol::state_view state)
 	{
 		bool shouldRun = true;
@@ -31,7 +46,13 @@ namespace latte
 		SDL_Event evnt{};
 		while (SDL_WaitEvent(&evnt) && shouldRun)
 		{
+			// Updates made while handling input jump ahead of any background work
+			ComponentSystem::getInstance().setUpdateLane(isInputEvent(evnt.type) ? UPDATE_LANE_INPUT : UPDATE_LANE_BACKGROUND);
 			handleEvents(&evnt, state);
+			ComponentSystem::getInstance().setUpdateLane(UPDATE_LANE_BACKGROUND);
+
+			// Commits present and handlers finish inside handleEvents, so nothing allocated from the arena is still in use
+			FrameArena::getInstance().reset();
 
 			shouldRun = m_WindowManager.isSomeWindowOpen();
 
@@ -45,22 +66,97 @@ namespace latte
 
 	void EventLoop::pushRepaint(std::shared_ptr<Window> win)
 	{
-		auto* window_ptr = new std::shared_ptr<Window>(win);
-
-		SDL_Event evnt{};
-		evnt.type = engine_event_type_base + ENGINE_EVENT_REPAINT;
-		evnt.user.data1 = window_ptr;
-		SDL_PushEvent(&evnt);
+		win->invalidate(INVALIDATE_PAINT);
+		scheduleCommit();
 	}
 
 	void EventLoop::pushRelayout(std::shared_ptr<Window> win)
 	{
-		auto* window_ptr = new std::shared_ptr<Window>(win);
+		win->invalidate(INVALIDATE_LAYOUT | INVALIDATE_PAINT);
+		scheduleCommit();
+	}
+
+	void EventLoop::pushRebuild(std::shared_ptr<Window> win)
+	{
+		win->invalidate(INVALIDATE_BUILD);
+		scheduleCommit();
+	}
+
+	void EventLoop::endBatch()
+	{
+		if (m_BatchDepth > 0)
+			m_BatchDepth--;
+
+		if (m_BatchDepth == 0 && m_CommitDeferred)
+		{
+			m_CommitDeferred = false;
+			scheduleCommit();
+		}
+	}
+
+	void EventLoop::scheduleCommit()
+	{
+		if (m_BatchDepth > 0)
+		{
+			m_CommitDeferred = true;
+			return;
+		}
+
+		// One commit event covers every invalidation until it is handled
+		if (m_CommitQueued)
+			return;
 
 		SDL_Event evnt{};
-		evnt.type = engine_event_type_base + ENGINE_EVENT_RELAYOUT;
-		evnt.user.data1 = window_ptr;
+		evnt.type = engine_event_type_base + ENGINE_EVENT_COMMIT;
 		SDL_PushEvent(&evnt);
+
+		m_CommitQueued = true;
+	}
+
+	void EventLoop::commit()
+	{
+		m_CommitQueued = false;
+
+		ComponentSystem& system = ComponentSystem::getInstance();
+		const Uint64 deadline = SDL_GetTicksNS() + FRAME_BUDGET_NS;
+
+		// Root rebuilds only build the top level, the components under them are queued as work
+		m_WindowManager.foreach([&](std::shared_ptr<Window> win) {
+			win->build();
+		});
+
+		const bool finished = system.performWork(deadline);
+
+		// Windows part way through an update keep showing their last complete frame,
+		// the rest are presented even while other windows carry on building
+		std::pmr::unordered_set<LatteNode*> busyRoots = system.getBusyRoots();
+
+		m_WindowManager.foreach([&](std::shared_ptr<Window> win) {
+			if (busyRoots.contains(win->getRootNode()))
+				return;
+
+			uint32_t flags = win->takeInvalidation();
+
+			if (flags & INVALIDATE_LAYOUT)
+				win->layout();
+
+			if (flags & INVALIDATE_PAINT)
+			{
+				latte::renderRoot(win);
+				win->present();
+			}
+		});
+
+		// The frame is out, now run effects from the components that were built for it.
+		// Effects in windows that were held back wait until their update is on screen
+		system.flushEffects(&busyRoots);
+
+		// Removed subtrees are freed a slice at a time after present instead of in the frame that removed them
+		const bool destroyed = system.destroyDetached(SDL_GetTicksNS() + DESTROY_BUDGET_NS);
+
+		// Carry on next time round, SDL_PushEvent puts this behind any input that arrived meanwhile
+		if (!finished || !destroyed)
+			scheduleCommit();
 	}
 
 	void EventLoop::handleEvents(SDL_Event* evnt, sol::state_view state)
@@ -144,7 +240,7 @@ namespace latte
 			KeyDownEvent kde{};
 			kde.keyCode = evnt->key.key;
 			kde.name = std::string(SDL_GetKeyName(kde.keyCode));
-			kde.keyMods = getKeyModNames(evnt->key.mod);
+			kde.keyMods = getKeyMods(evnt->key.mod);
 
 			std::transform(
 				kde.name.begin(), kde.name.end(), kde.name.begin(),
@@ -152,7 +248,7 @@ namespace latte
 			);
 
 
-			Event latteEvent = kde;
+			Event latteEvent = std::move(kde);
 			LatteNode* node = ComponentSystem::getInstance().getFocusedNode();
 			if (node)
 			{
@@ -168,7 +264,7 @@ namespace latte
 
 			// TODO: Handle window 
 
-			Event latteEvent = tie;
+			Event latteEvent = std::move(tie);
 			LatteNode* node = ComponentSystem::getInstance().getFocusedNode();
 			if (node)
 			{
@@ -179,19 +275,9 @@ namespace latte
 		}
 		}
 
-		if (evnt->type == engine_event_type_base + ENGINE_EVENT_REPAINT)
-		{
-			auto* win_sp = (std::shared_ptr<Window>*)evnt->user.data1;
-			latte::renderRoot(*win_sp);
-			(*win_sp)->present();
-			delete win_sp;
-		}
-		else if (evnt->type == engine_event_type_base + ENGINE_EVENT_RELAYOUT)
+		if (evnt->type == engine_event_type_base + ENGINE_EVENT_COMMIT)
 		{
-			auto* win_sp = (std::shared_ptr<Window>*)evnt->user.data1;
-			(*win_sp)->layout();
-			pushRepaint(*win_sp); 
-			delete win_sp;
+			commit();
 		}
 	}
-}
\ No newline at end of file
+}
@@ -12,8 +12,7 @@ namespace latte
 {
 
 	enum EngineEvents {
-		ENGINE_EVENT_RELAYOUT = 0,
-		ENGINE_EVENT_REPAINT = 1,
+		ENGINE_EVENT_COMMIT = 0,	// Builds queued components for a time slice, then lays out and paints invalidated windows
 		ENGINE_EVENT_COUNT
 	};
 
@@ -27,14 +26,47 @@ namespace latte
 
 		[[nodiscard]] WindowManager& getWindowManager() noexcept { return m_WindowManager; }
 
+		/*
+			Invalidate a window, the work is deduplicated and done once at the next commit
+		*/
 		void pushRepaint(std::shared_ptr<Window> win);
 		void pushRelayout(std::shared_ptr<Window> win);
 
+		/*
+			Dirty components need rebuilding, layout and paint are only scheduled if the rebuild changes what they depend on
+		*/
+		void pushRebuild(std::shared_ptr<Window> win);
+
+		/*
+			While a batch is open no commit is scheduled, 
+			everything invalidated inside it is committed together when the outermost batch ends
+		*/
+		void beginBatch() noexcept { m_BatchDepth++; }
+		void endBatch();
+
 	private:
 
+		// How long a commit spends building components before yielding back to the event loop
+		static constexpr Uint64 FRAME_BUDGET_NS = 8'000'000;
+
+		// How long a commit spends freeing removed subtrees once its frame is presented
+		static constexpr Uint64 DESTROY_BUDGET_NS = 2'000'000;
+
 		void handleEvents(SDL_Event* evnt, sol::state_view state);
+
+		void scheduleCommit();
+
+		void commit();
 		
 		WindowManager m_WindowManager;
+
+		// Is there a commit event already in the SDL queue
+		bool m_CommitQueued = false;
+
+		// Was something invalidated while a batch was open
+		bool m_CommitDeferred = false;
+
+		int m_BatchDepth = 0;
 	};
 }
 
@@ -156,22 +156,35 @@ namespace latte
 		SDL_GL_MakeCurrent(m_Window, m_Context);
 	}
 
-	void Window::layout()
+	void Window::build()
 	{
-		latteSizer(
-			m_RootNode,
-			LATTE_SIZER_FIXED((float)m_Width),
-			LATTE_SIZER_FIXED((float)m_Height)
-		);
+		if (!m_NeedsRebuild)
+			return;
 
-		latte::ComponentSystem::getInstance().pushID(m_RootNode->id);
+		latte::ComponentSystem& system = latte::ComponentSystem::getInstance();
+		system.pushNode(m_RootNode);
 
 		if (m_RootTable != sol::nil)
 		{
 			latte::applyPropsFromTable(m_RootNode, m_RootTable, false);
 		}
 
-		latte::ComponentSystem::getInstance().popID();
+		system.popNode();
+
+		// The whole tree may have changed shape
+		(void)system.takeChanges();
+		invalidate(INVALIDATE_LAYOUT | INVALIDATE_PAINT);
+
+		m_NeedsRebuild = false;
+	}
+
+	void Window::layout()
+	{
+		latteSizer(
+			m_RootNode,
+			LATTE_SIZER_FIXED((float)m_Width),
+			LATTE_SIZER_FIXED((float)m_Height)
+		);
 
 		lattePropogateDirty(m_RootNode);
 
@@ -32,6 +32,17 @@ namespace latte
 		WINDOW_FLAG_MICA = 1 << 16
 	};
 
+	/*
+		What a window needs doing at the next frame commit
+	*/
+	enum WindowInvalidation : uint32_t
+	{
+		INVALIDATE_NONE = 0,
+		INVALIDATE_LAYOUT = 1 << 0,		// Lay out the whole tree
+		INVALIDATE_PAINT = 1 << 1,		// Repaint and present
+		INVALIDATE_BUILD = 1 << 2		// Components are queued, layout and paint are added by the work if it changes something they use
+	};
+
 	class Window
 	{
 	public:
@@ -54,11 +65,36 @@ namespace latte
 		[[nodiscard]] const int getWidth() const noexcept { return m_Width; }
 		[[nodiscard]] const int getHeight() const noexcept { return m_Height; }
 
-		void setLuaRootTable(sol::table table) noexcept { m_RootTable = table; }
+		/*
+			Sets the table the whole tree is built from, the next layout rebuilds everything from it
+		*/
+		void setLuaRootTable(sol::table table) noexcept 
+		{ 
+			m_RootTable = table; 
+			m_NeedsRebuild = true;
+		}
 		[[nodiscard]] sol::table getLuaRootTable() const noexcept { return m_RootTable; }
 
+		/*
+			Rebuilds the top level of the tree from the root table if it has been set since the last build. 
+			Components under it are queued as work on the component system
+		*/
+		void build();
+
 		void layout();
 
+		void invalidate(uint32_t flags) noexcept { m_Invalidation |= flags; }
+
+		/*
+			Returns and clears the pending invalidation flags
+		*/
+		[[nodiscard]] uint32_t takeInvalidation() noexcept
+		{
+			uint32_t flags = m_Invalidation;
+			m_Invalidation = INVALIDATE_NONE;
+			return flags;
+		}
+
 		[[nodiscard]] bool valid() const noexcept
 		{
 			return m_Window != nullptr;
@@ -81,6 +117,11 @@ namespace latte
 
 		LatteNode* m_RootNode = nullptr;
 		sol::table m_RootTable = {};
+
+		// When false a build only rebuilds components that have been marked dirty
+		bool m_NeedsRebuild = false;
+
+		uint32_t m_Invalidation = INVALIDATE_NONE;
 	};
 }
 
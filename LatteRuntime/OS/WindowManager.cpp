@@ -31,6 +31,23 @@ namespace latte
 		return nullptr;
 	}
 
+	std::shared_ptr<Window> WindowManager::getWindowForNode(LatteNode* node)
+	{
+		if (node == nullptr)
+			return nullptr;
+
+		while (node->parent != nullptr)
+			node = node->parent;
+
+		for (auto& [id, window] : m_Windows)
+		{
+			if (window->getRootNode() == node)
+				return window;
+		}
+
+		return nullptr;
+	}
+
 	void WindowManager::removeWindow(uint32_t id)
 	{
 		m_Windows.erase(id);
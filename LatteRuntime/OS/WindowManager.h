@@ -21,6 +21,11 @@ namespace latte
 
 		std::shared_ptr<Window> getWindowById(const uint32_t id);
 
+		/*
+			Returns the window whose node tree contains the node, or nullptr if it isn't in any window
+		*/
+		std::shared_ptr<Window> getWindowForNode(LatteNode* node);
+
 		void foreach(std::function<void(std::shared_ptr<Window>)> func);
 
 		void removeWindow(uint32_t id);
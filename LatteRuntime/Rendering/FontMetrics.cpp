@@ -9,18 +9,12 @@ namespace latte
 	{
 	}
 
-	sol::table FontMetrics::getTextSize(const std::string& str)
+	sol::table FontMetrics::getTextSize(std::string_view str)
 	{
-		NVGcontext* vg = RenderInterface::getInstance().getNVGContext();
-
-		nvgFontFace(vg, m_FontName.c_str());
-		nvgFontSize(vg, m_FontSize);
-
-		float bb[4];
-		float w = nvgTextBounds(vg, 0.0f, 0.0f, str.c_str(), nullptr, bb);
-		float h = bb[3] - bb[1];
+		float h = 0.0f;
+		float w = measureText(m_FontName.c_str(), m_FontSize, str.data(), str.size(), &h);
 
-		sol::table result = m_StateView.create_table();
+		sol::table result = m_StateView.create_table(0, 2);
 
 		result["width"] = w;
 		result["height"] = h;
@@ -29,14 +23,41 @@ namespace latte
 	}
 
 	float FontMetrics::getLineHeight()
+	{
+		return measureLineHeight(m_FontName.c_str(), m_FontSize);
+	}
+
+	float FontMetrics::measureText(const char* fontFace, float fontSize, const char* str, size_t length, float* height)
+	{
+		NVGcontext* vg = RenderInterface::getInstance().getNVGContext();
+
+		// Can be called mid paint, the renderer relies on the font it last set still being there
+		nvgSave(vg);
+		nvgFontFace(vg, fontFace);
+		nvgFontSize(vg, fontSize);
+
+		// Bounded by length so the string doesn't need to be null terminated
+		float bb[4];
+		float w = nvgTextBounds(vg, 0.0f, 0.0f, str, str + length, bb);
+		nvgRestore(vg);
+
+		if (height)
+			*height = bb[3] - bb[1];
+
+		return w;
+	}
+
+	float FontMetrics::measureLineHeight(const char* fontFace, float fontSize)
 	{
 		NVGcontext* vg = RenderInterface::getInstance().getNVGContext();
 
-		nvgFontFace(vg, m_FontName.c_str());
-		nvgFontSize(vg, m_FontSize);
+		nvgSave(vg);
+		nvgFontFace(vg, fontFace);
+		nvgFontSize(vg, fontSize);
 
 		float h = 0.0f;
 		nvgTextMetrics(vg, NULL, NULL, &h);
+		nvgRestore(vg);
 
 		return h;
 	}
@@ -4,6 +4,7 @@
 
 #include <sol/sol.hpp>
 #include <string>
+#include <string_view>
 
 namespace latte
 {
@@ -22,10 +23,18 @@ namespace latte
 		/*
 			Returns a Lua table with [width] and [height] of the specified string as text
 		*/
-		sol::table getTextSize(const std::string& str);
+		sol::table getTextSize(std::string_view str);
 
 		float getLineHeight();
 
+		/*
+			Width of length bytes of str, the height is written to height if it isn't null.
+			Shared with the FFI fast path so neither needs a std::string
+		*/
+		static float measureText(const char* fontFace, float fontSize, const char* str, size_t length, float* height);
+
+		static float measureLineHeight(const char* fontFace, float fontSize);
+
 		/*
 			Registers the usertype with lua
 		*/
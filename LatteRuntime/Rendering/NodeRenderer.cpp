@@ -67,6 +67,21 @@ namespace latte
 		return m_NVGcontext;
 	}
 
+	// The style last set on the NanoVG context during this paint
+	static StyleId lastPaintedStyle = STYLE_ID_DEFAULT;
+	static WidgetType lastPaintedType = WIDGET_TYPE_BOX;
+	static bool paintStateValid = false;
+
+	static NVGcolor unpackColor(PackedColor color)
+	{
+		return nvgRGBA(
+			(unsigned char)(color >> 24), 
+			(unsigned char)(color >> 16), 
+			(unsigned char)(color >> 8), 
+			(unsigned char)color
+		);
+	}
+
 	void renderNode(LatteNode* node, NVGcontext* vg)
 	{
 		nvgBeginPath(vg);
@@ -81,63 +96,43 @@ namespace latte
 			{
 				auto itr = data->eventCallbacks.find(COMPONENT_EVENT_PAINT);
 				if (itr != data->eventCallbacks.end())
+				{
+					// The callback can draw or measure text, the state cached for the next node has to survive it
+					nvgSave(vg);
 					shouldPaint = itr->second();
+					nvgRestore(vg);
+				}
 			}
 
 			if (shouldPaint)
 			{
+				const ResolvedStyle& style = StylePool::getInstance().get(data->style);
+
+				// Nodes sharing a style with the last painted node can skip setting it again
+				bool styleApplied = paintStateValid && data->style == lastPaintedStyle && data->type == lastPaintedType;
+				lastPaintedStyle = data->style;
+				lastPaintedType = data->type;
+				paintStateValid = true;
+
 				if (data->type == latte::WIDGET_TYPE_BOX)
 				{
-					float btr = 0.0f, btl = 0.0f, bbr = 0.0f, bbl = 0.0f;
-					bool hasBorder = false;
-					bool hasFill = false;
+					float btl = style.borderRadius[0];
+					float btr = style.borderRadius[1];
+					float bbr = style.borderRadius[2];
+					float bbl = style.borderRadius[3];
+					bool hasBorder = (style.flags & STYLE_FLAG_BORDER) != 0;
+					bool hasFill = (style.flags & STYLE_FLAG_BACKGROUND) != 0;
+
+					if (hasFill && !styleApplied)
+						nvgFillColor(vg, unpackColor(style.backgroundColor));
 
-					if (data->style.valid())
+					if (hasBorder && !styleApplied)
 					{
-						sol::table style = data->style;
-
-						if (style["backgroundColor"].valid())
-						{
-							float r = style["backgroundColor"][1];
-							float g = style["backgroundColor"][2];
-							float b = style["backgroundColor"][3];
-							float a = style["backgroundColor"][4];
-
-							nvgFillColor(vg, nvgRGBAf(r, g, b, a));
-							hasFill = true;
-						}
-
-						if (style["borderRadius"].valid())
-						{
-							btl = style["borderRadius"][1];
-							btr = style["borderRadius"][2];
-							bbr = style["borderRadius"][3];
-							bbl = style["borderRadius"][4];
-						}
-
-						if (style["border"].valid())
-						{
-							sol::table border = style["border"].get<sol::table>();
-							float width = border.get_or("width", 0.0f);
-
-							if (width > 0.0f)
-							{
-								hasBorder = true;
-
-								// TODO: Not this
-								nvgStrokeWidth(vg, width);
-
-								if (border["color"].valid())
-								{
-									float r = border["color"][1];
-									float g = border["color"][2];
-									float b = border["color"][3];
-									float a = border["color"][4];
-
-									nvgStrokeColor(vg, nvgRGBAf(r, g, b, a));
-								}
-							}
-						}
+						// TODO: Not this
+						nvgStrokeWidth(vg, style.borderWidth);
+
+						if (style.flags & STYLE_FLAG_BORDER_COLOR)
+							nvgStrokeColor(vg, unpackColor(style.borderColor));
 					}
 
 					float halfWidth = node->size.width / 2.0f;
@@ -172,29 +167,16 @@ namespace latte
 				}
 				else
 				{
-					float fontSize = 14.0f;
-					if (data->style.valid())
+					if (!styleApplied)
 					{
-						sol::table style = data->style;
+						nvgFillColor(vg, unpackColor(style.color));
 
-						if (style["color"].valid())
-						{
-							float r = style["color"][1];
-							float g = style["color"][2];
-							float b = style["color"][3];
-							float a = style["color"][4];
-
-							nvgFillColor(vg, nvgRGBAf(r, g, b, a));
-						}
+						if (style.fontHandle >= 0)
+							nvgFontFaceId(vg, style.fontHandle);
 						else
-						{
-							nvgFillColor(vg, nvgRGB(0, 0, 0));
-						}
-
-						fontSize = style.get_or("fontSize", 14.0f);
+							nvgFontFace(vg, "Roboto-Regular");
+						nvgFontSize(vg, style.fontSize);
 					}
-					nvgFontFace(vg, "Roboto-Regular");
-					nvgFontSize(vg, fontSize);
 
 					float ascender, descender, lineh;
 					nvgTextMetrics(vg, &ascender, &descender, &lineh);
@@ -240,6 +222,9 @@ namespace latte
 
 		nvgBeginFrame(vg, win->getWidth(), win->getHeight(), 1.0f);
 
+		// Begin frame resets the NanoVG state
+		paintStateValid = false;
+
 		renderNode(win->getRootNode(), vg);
 
 		nvgEndFrame(vg);
@@ -0,0 +1,204 @@
+#include "ResolvedStyle.h"
+#include "NodeRenderer.h"
+#include <nanovg.h>
+#include "../Components/Signal.h"
+#include "../Utils/Hash.h"
+#include <bit>
+#include <unordered_map>
+
+namespace latte
+{
+	uint64_t hashStyle(const ResolvedStyle& style) noexcept
+	{
+		auto floatBits = [](float value) -> uint64_t { return std::bit_cast<uint32_t>(value); };
+
+		uint64_t hash = hashCombine(style.flags, style.backgroundColor);
+		hash = hashCombine(hash, style.borderColor);
+		hash = hashCombine(hash, style.color);
+		for (float radius : style.borderRadius)
+			hash = hashCombine(hash, floatBits(radius));
+		hash = hashCombine(hash, floatBits(style.borderWidth));
+		hash = hashCombine(hash, floatBits(style.fontSize));
+		return hashCombine(hash, (uint64_t)(int64_t)style.fontHandle);
+	}
+
+	bool readColor(const sol::object& obj, PackedColor& out)
+	{
+		if (obj.get_type() != sol::type::table)
+			return false;
+
+		sol::table color = obj.as<sol::table>();
+		out = packColor(
+			color.get_or(1, 0.0f),
+			color.get_or(2, 0.0f),
+			color.get_or(3, 0.0f),
+			color.get_or(4, 1.0f)
+		);
+
+		return true;
+	}
+
+	// Reads a color that may be a signal, the signal is reported so the node can be bound to it
+	static bool readColor(const sol::object& obj, PackedColor& out, std::shared_ptr<Signal>* signal)
+	{
+		if (signal && obj.get_type() == sol::type::userdata && obj.is<std::shared_ptr<Signal>>())
+		{
+			*signal = obj.as<std::shared_ptr<Signal>>();
+			return readColor((*signal)->get(), out);
+		}
+
+		return readColor(obj, out);
+	}
+
+	ResolvedStyle resolveStyle(sol::table style, StyleSignals* signals)
+	{
+		ResolvedStyle resolved{};
+
+		if (readColor(style["backgroundColor"], resolved.backgroundColor, signals ? &signals->backgroundColor : nullptr))
+			resolved.flags |= STYLE_FLAG_BACKGROUND;
+
+		if (readColor(style["color"], resolved.color, signals ? &signals->color : nullptr))
+			resolved.flags |= STYLE_FLAG_COLOR;
+
+		sol::object radius = style["borderRadius"];
+		if (radius.get_type() == sol::type::table)
+		{
+			sol::table r = radius.as<sol::table>();
+			for (int i = 0; i < 4; i++)
+				resolved.borderRadius[i] = r.get_or(i + 1, 0.0f);
+		}
+
+		sol::object border = style["border"];
+		if (border.get_type() == sol::type::table)
+		{
+			sol::table b = border.as<sol::table>();
+			resolved.borderWidth = b.get_or("width", 0.0f);
+
+			if (resolved.borderWidth > 0.0f)
+				resolved.flags |= STYLE_FLAG_BORDER;
+
+			if (readColor(b["color"], resolved.borderColor, signals ? &signals->borderColor : nullptr))
+				resolved.flags |= STYLE_FLAG_BORDER_COLOR;
+		}
+
+		resolved.fontSize = style.get_or("fontSize", 14.0f);
+
+		std::string fontFace = style.get_or("fontFace", std::string("Roboto-Regular"));
+		resolved.fontHandle = nvgFindFont(RenderInterface::getInstance().getNVGContext(), fontFace.c_str());
+
+		return resolved;
+	}
+
+	// Compiled styles by the hash of their table's contents, so a style written out again
+	// each build hits as well as one kept in a table that is reused
+	static std::unordered_map<uint64_t, ResolvedStyle> s_CompiledStyles;
+	static uint64_t s_CompileHits = 0;
+	static uint64_t s_CompileMisses = 0;
+
+	// Cleared rather than evicted when full, styles are few and it refills within a build
+	static constexpr size_t STYLE_CACHE_LIMIT = 1024;
+
+	// Style tables nest at most a color inside border
+	static constexpr int STYLE_MAX_DEPTH = 3;
+
+	static bool hashStyleTable(lua_State* L, int index, int depth, uint64_t& out);
+
+	// False for anything that isn't plain data, signals and functions can't be cached
+	static bool hashStyleValue(lua_State* L, int index, int depth, uint64_t& out)
+	{
+		switch (lua_type(L, index))
+		{
+		case LUA_TNUMBER:
+			out = hashCombine(LUA_TNUMBER, std::bit_cast<uint64_t>((double)lua_tonumber(L, index)));
+			return true;
+		case LUA_TBOOLEAN:
+			out = hashCombine(LUA_TBOOLEAN, (uint64_t)lua_toboolean(L, index));
+			return true;
+		case LUA_TSTRING:
+		{
+			size_t length = 0;
+			const char* str = lua_tolstring(L, index, &length);
+			out = hashCombine(LUA_TSTRING, hashString(std::string_view(str, length)));
+			return true;
+		}
+		case LUA_TTABLE:
+			return hashStyleTable(L, index, depth + 1, out);
+		default:
+			return false;
+		}
+	}
+
+	static bool hashStyleTable(lua_State* L, int index, int depth, uint64_t& out)
+	{
+		if (depth > STYLE_MAX_DEPTH)
+			return false;
+
+		// Each pair is hashed on its own and summed, so the order lua_next walks them in doesn't matter
+		uint64_t sum = 0;
+		uint64_t count = 0;
+
+		lua_pushnil(L);
+		while (lua_next(L, index) != 0)
+		{
+			const int top = lua_gettop(L);
+
+			uint64_t key = 0;
+			uint64_t value = 0;
+			if (!hashStyleValue(L, top - 1, depth, key) || !hashStyleValue(L, top, depth, value))
+			{
+				lua_pop(L, 2);
+				return false;
+			}
+
+			sum += hashCombine(key, value);
+			count++;
+
+			lua_pop(L, 1);
+		}
+
+		out = hashCombine(hashCombine(LUA_TTABLE, count), sum);
+		return true;
+	}
+
+	ResolvedStyle resolveStyle(lua_State* L, int index, StyleSignals* signals)
+	{
+		if (index < 0 && index > LUA_REGISTRYINDEX)
+			index = lua_gettop(L) + index + 1;
+
+		uint64_t hash = 0;
+		if (!hashStyleTable(L, index, 0, hash))
+			return resolveStyle(sol::table(L, index), signals);
+
+		auto itr = s_CompiledStyles.find(hash);
+		if (itr != s_CompiledStyles.end())
+		{
+			s_CompileHits++;
+			return itr->second;
+		}
+
+		s_CompileMisses++;
+
+		ResolvedStyle resolved = resolveStyle(sol::table(L, index), signals);
+
+		// A font that isn't loaded yet could be by the next build, so only found fonts are kept
+		if (resolved.fontHandle >= 0)
+		{
+			if (s_CompiledStyles.size() >= STYLE_CACHE_LIMIT)
+				s_CompiledStyles.clear();
+
+			s_CompiledStyles.emplace(hash, resolved);
+		}
+
+		return resolved;
+	}
+
+	uint64_t getStyleCompileHits() noexcept
+	{
+		return s_CompileHits;
+	}
+
+	uint64_t getStyleCompileMisses() noexcept
+	{
+		return s_CompileMisses;
+	}
+}
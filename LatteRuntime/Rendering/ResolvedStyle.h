@@ -0,0 +1,102 @@
+#ifndef LATTE_RESOLVED_STYLE_H
+#define LATTE_RESOLVED_STYLE_H
+
+#include <sol/sol.hpp>
+#include <cstdint>
+#include <memory>
+
+namespace latte
+{
+	enum StyleFlags : uint32_t
+	{
+		STYLE_FLAG_NONE = 0,
+		STYLE_FLAG_BACKGROUND = 1 << 0,		// backgroundColor was set
+		STYLE_FLAG_BORDER = 1 << 1,			// border with a width above 0
+		STYLE_FLAG_BORDER_COLOR = 1 << 2,	// border.color was set
+		STYLE_FLAG_COLOR = 1 << 3			// color was set
+	};
+
+	/*
+		Colors are packed as 0xRRGGBBAA
+	*/
+	using PackedColor = uint32_t;
+
+	inline PackedColor packColor(float r, float g, float b, float a)
+	{
+		auto channel = [](float v) -> uint32_t {
+			v = v < 0.0f ? 0.0f : (v > 1.0f ? 1.0f : v);
+			return (uint32_t)(v * 255.0f + 0.5f);
+		};
+
+		return (channel(r) << 24) | (channel(g) << 16) | (channel(b) << 8) | channel(a);
+	}
+
+	/*
+		A Lua style table compiled down to plain data. 
+
+		This is built when a node's props are applied, so painting never has to touch Lua.
+	*/
+	struct ResolvedStyle
+	{
+		uint32_t flags = STYLE_FLAG_NONE;
+
+		PackedColor backgroundColor = 0;
+		PackedColor borderColor = 0;
+
+		// Text color, black unless the style sets one
+		PackedColor color = 0x000000FF;
+
+		// Top left, top right, bottom right, bottom left
+		float borderRadius[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+		float borderWidth = 0.0f;
+
+		float fontSize = 14.0f;
+
+		// NanoVG font handle, -1 if the font couldn't be found
+		int fontHandle = -1;
+
+		bool operator==(const ResolvedStyle& other) const = default;
+	};
+
+	/*
+		Hash of every field, equal styles always hash the same
+	*/
+	uint64_t hashStyle(const ResolvedStyle& style) noexcept;
+
+	class Signal;
+
+	/*
+		Colors in the style that were given as a latte.signal, resolved with the signal's current value
+	*/
+	struct StyleSignals
+	{
+		std::shared_ptr<Signal> backgroundColor;
+		std::shared_ptr<Signal> color;
+		std::shared_ptr<Signal> borderColor;
+	};
+
+	/*
+		Compiles a style table from Lua into a ResolvedStyle, 
+		signals are only accepted for colors and only reported if signals isn't null
+	*/
+	ResolvedStyle resolveStyle(sol::table style, StyleSignals* signals = nullptr);
+
+	/*
+		The same for the style table at a stack index, but styles made only of plain data are
+		cached by a hash of their contents so an unchanged style isn't compiled again every build
+	*/
+	ResolvedStyle resolveStyle(lua_State* L, int index, StyleSignals* signals = nullptr);
+
+	/*
+		How often resolveStyle found a style already compiled, for latte.getStyleStats
+	*/
+	uint64_t getStyleCompileHits() noexcept;
+	uint64_t getStyleCompileMisses() noexcept;
+
+	/*
+		Packs a color table, false if the object isn't one
+	*/
+	bool readColor(const sol::object& obj, PackedColor& out);
+}
+
+#endif // LATTE_RESOLVED_STYLE_H
@@ -0,0 +1,77 @@
+#include "StylePool.h"
+
+namespace latte
+{
+	StylePool::StylePool()
+	{
+		Entry def{};
+		def.hash = hashStyle(def.style);
+		def.refCount = 1;
+
+		m_Entries.push_back(def);
+		m_Lookup.emplace(def.hash, STYLE_ID_DEFAULT);
+	}
+
+	StyleId StylePool::acquire(const ResolvedStyle& style)
+	{
+		size_t hash = hashStyle(style);
+
+		auto range = m_Lookup.equal_range(hash);
+		for (auto itr = range.first; itr != range.second; ++itr)
+		{
+			Entry& entry = m_Entries[itr->second];
+			if (entry.style == style)
+			{
+				entry.refCount++;
+				m_Hits++;
+				return itr->second;
+			}
+		}
+
+		m_Misses++;
+
+		StyleId id;
+		if (!m_FreeList.empty())
+		{
+			id = m_FreeList.back();
+			m_FreeList.pop_back();
+		}
+		else
+		{
+			id = (StyleId)m_Entries.size();
+			m_Entries.emplace_back();
+		}
+
+		Entry& entry = m_Entries[id];
+		entry.style = style;
+		entry.hash = hash;
+		entry.refCount = 1;
+
+		m_Lookup.emplace(hash, id);
+
+		return id;
+	}
+
+	void StylePool::release(StyleId id)
+	{
+		// The default style is never freed
+		if (id == STYLE_ID_DEFAULT)
+			return;
+
+		Entry& entry = m_Entries[id];
+		if (--entry.refCount > 0)
+			return;
+
+		auto range = m_Lookup.equal_range(entry.hash);
+		for (auto itr = range.first; itr != range.second; ++itr)
+		{
+			if (itr->second == id)
+			{
+				m_Lookup.erase(itr);
+				break;
+			}
+		}
+
+		m_FreeList.push_back(id);
+	}
+}
@@ -0,0 +1,71 @@
+#ifndef LATTE_STYLE_POOL_H
+#define LATTE_STYLE_POOL_H
+
+#include "../Utils/Singleton.h"
+#include "ResolvedStyle.h"
+#include <vector>
+#include <unordered_map>
+
+namespace latte
+{
+	using StyleId = uint32_t;
+
+	// The default style, always in the pool and never freed
+	constexpr StyleId STYLE_ID_DEFAULT = 0;
+
+	/*
+		Interns resolved styles so nodes with identical styles share one immutable entry.
+
+		Entries are ref counted by the nodes using them. Sharing ids also lets 
+		the renderer skip redundant state changes between nodes with the same style.
+	*/
+	class StylePool : public Singleton<StylePool>
+	{
+	public:
+
+		StylePool();
+
+		/*
+			Returns the id for a style, adding it if there isn't an identical one. 
+			The returned id holds a reference which must be given back with release
+		*/
+		StyleId acquire(const ResolvedStyle& style);
+
+		void release(StyleId id);
+
+		[[nodiscard]] const ResolvedStyle& get(StyleId id) const { return m_Entries[id].style; }
+
+		/*
+			Number of live unique styles
+		*/
+		[[nodiscard]] size_t size() const noexcept { return m_Entries.size() - m_FreeList.size(); }
+
+		[[nodiscard]] uint64_t getHits() const noexcept { return m_Hits; }
+		[[nodiscard]] uint64_t getMisses() const noexcept { return m_Misses; }
+
+		[[nodiscard]] float getHitRate() const noexcept
+		{
+			uint64_t total = m_Hits + m_Misses;
+			return total == 0 ? 0.0f : (float)m_Hits / (float)total;
+		}
+
+	private:
+
+		struct Entry
+		{
+			ResolvedStyle style;
+			size_t hash = 0;
+			uint32_t refCount = 0;
+		};
+
+		std::vector<Entry> m_Entries;
+		std::vector<StyleId> m_FreeList;
+
+		std::unordered_multimap<size_t, StyleId> m_Lookup;
+
+		uint64_t m_Hits = 0;
+		uint64_t m_Misses = 0;
+	};
+}
+
+#endif // LATTE_STYLE_POOL_H
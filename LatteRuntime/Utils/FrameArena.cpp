@@ -0,0 +1,35 @@
+#include "FrameArena.h"
+
+namespace latte
+{
+	void* FrameArena::OverflowResource::do_allocate(size_t bytes, size_t alignment)
+	{
+		overflow += bytes;
+		return std::pmr::new_delete_resource()->allocate(bytes, alignment);
+	}
+
+	void FrameArena::OverflowResource::do_deallocate(void* p, size_t bytes, size_t alignment)
+	{
+		std::pmr::new_delete_resource()->deallocate(p, bytes, alignment);
+	}
+
+	FrameArena::FrameArena() : m_Buffer(INITIAL_CAPACITY)
+	{
+		m_Resource.emplace(m_Buffer.data(), m_Buffer.size(), &m_Upstream);
+	}
+
+	void FrameArena::reset()
+	{
+		m_Resource->release();
+
+		if (m_Upstream.overflow == 0)
+			return;
+
+		// Big enough for everything this frame needed, with headroom so a slowly growing workload doesn't regrow every frame
+		size_t capacity = m_Buffer.size() + m_Upstream.overflow;
+		m_Buffer.resize(capacity + capacity / 2);
+		m_Upstream.overflow = 0;
+
+		m_Resource.emplace(m_Buffer.data(), m_Buffer.size(), &m_Upstream);
+	}
+}
@@ -0,0 +1,62 @@
+#ifndef LATTE_FRAME_ARENA_H
+#define LATTE_FRAME_ARENA_H
+
+#include "Singleton.h"
+#include <memory_resource>
+#include <optional>
+#include <vector>
+#include <cstddef>
+
+namespace latte
+{
+	/*
+		Memory for temporaries that only live until the end of the current frame,
+		pass getResource() to pmr containers in hot paths instead of using the general heap.
+
+		Allocating is a pointer bump and freeing does nothing, everything is released at once by reset
+		after the frame is presented. Nothing allocated from it can be kept past that.
+		If a frame outgrows the buffer the extra comes from the heap and the buffer is grown at the next reset,
+		so a steady workload stops touching the heap after its first few frames
+	*/
+	class FrameArena : public Singleton<FrameArena>
+	{
+	public:
+
+		FrameArena();
+
+		[[nodiscard]] std::pmr::memory_resource* getResource() noexcept { return &*m_Resource; }
+
+		/*
+			Frees everything allocated this frame
+		*/
+		void reset();
+
+		[[nodiscard]] size_t getCapacity() const noexcept { return m_Buffer.size(); }
+
+	private:
+
+		// Counts what the arena had to take from the heap because the buffer ran out
+		class OverflowResource : public std::pmr::memory_resource
+		{
+		public:
+
+			size_t overflow = 0;
+
+		private:
+
+			void* do_allocate(size_t bytes, size_t alignment) override;
+			void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+			bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+		};
+
+		static constexpr size_t INITIAL_CAPACITY = 64 * 1024;
+
+		std::vector<std::byte> m_Buffer;
+		OverflowResource m_Upstream;
+
+		// Rebuilt when the buffer grows, a monotonic resource can't be pointed at a new buffer
+		std::optional<std::pmr::monotonic_buffer_resource> m_Resource;
+	};
+}
+
+#endif // LATTE_FRAME_ARENA_H
@@ -0,0 +1,37 @@
+#ifndef LATTE_HASH_H
+#define LATTE_HASH_H
+
+#include <cstdint>
+#include <string_view>
+
+namespace latte
+{
+	/*
+		64-bit FNV-1a, used for node identities and anything else that wants a cheap stable hash
+	*/
+	inline uint64_t hashString(std::string_view str) noexcept
+	{
+		uint64_t hash = 0xcbf29ce484222325ull;
+		for (char c : str)
+		{
+			hash ^= (uint8_t)c;
+			hash *= 0x100000001b3ull;
+		}
+
+		return hash;
+	}
+
+	/*
+		Mixes a value into an existing hash, order matters so (a, b) and (b, a) differ
+	*/
+	inline uint64_t hashCombine(uint64_t seed, uint64_t value) noexcept
+	{
+		// splitmix64 finaliser over the pair
+		uint64_t x = seed ^ (value + 0x9e3779b97f4a7c15ull + (seed << 6) + (seed >> 2));
+		x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ull;
+		x = (x ^ (x >> 27)) * 0x94d049bb133111ebull;
+		return x ^ (x >> 31);
+	}
+}
+
+#endif // LATTE_HASH_H
@@ -0,0 +1,189 @@
+#include "ScriptCache.h"
+#include "Hash.h"
+#include "Log.h"
+#include <SDL3/SDL.h>
+#include <filesystem>
+#include <fstream>
+#include <chrono>
+#include <cstring>
+#include <format>
+
+namespace fs = std::filesystem;
+
+namespace latte
+{
+	// Bytecode is specific to the Lua build that dumped it. LUA_VERSION_NUM is the same for every 5.1 build,
+	// so a cache tagged with it could hand one build another's bytecode
+#if !defined(LUAJIT_VERSION_NUM)
+#error "The bytecode cache needs LuaJIT, LUAJIT_VERSION_NUM is what tells its builds apart"
+#endif
+	static constexpr uint32_t BYTECODE_VERSION = LUAJIT_VERSION_NUM;
+
+	struct CacheHeader
+	{
+		char magic[8];
+		uint32_t version;
+		uint32_t pointerSize;
+		uint64_t sourceHash;
+		uint64_t parseNs;
+	};
+
+	static constexpr char CACHE_MAGIC[8] = { 'L', 'A', 'T', 'T', 'E', 'B', 'C', '1' };
+
+	static uint64_t nowNs()
+	{
+		return (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	static bool readFile(const fs::path& path, std::string& out)
+	{
+		std::ifstream file(path, std::ios::binary | std::ios::ate);
+		if (!file)
+			return false;
+
+		std::streamsize size = file.tellg();
+		if (size < 0)
+			return false;
+
+		out.resize((size_t)size);
+		file.seekg(0);
+		return (bool)file.read(out.data(), size);
+	}
+
+	static int writeChunk(lua_State*, const void* data, size_t size, void* userData)
+	{
+		((std::string*)userData)->append((const char*)data, size);
+		return 0;
+	}
+
+	// Scripts from different folders can share a name, so the entry is named after the whole path
+	static fs::path getCachePath(const std::string& directory, const std::string& path)
+	{
+		std::error_code ec;
+		fs::path source = fs::absolute(path, ec);
+		if (ec)
+			source = path;
+
+		return fs::path(directory) / std::format("{:016x}-{}.bc", hashString(source.generic_string()), source.filename().string());
+	}
+
+	const std::string& ScriptCache::getDirectory()
+	{
+		if (m_Directory.empty())
+		{
+			if (char* prefPath = SDL_GetPrefPath("LatteUI", "bytecode"))
+			{
+				m_Directory = prefPath;
+				SDL_free(prefPath);
+			}
+		}
+
+		return m_Directory;
+	}
+
+	sol::load_result ScriptCache::load(sol::state_view state, const std::string& path)
+	{
+		const uint64_t start = nowNs();
+		m_Stats.scripts++;
+
+		// No directory the user owns, parse every time rather than fall back to somewhere shared
+		std::string source;
+		if (!m_Enabled || getDirectory().empty() || !readFile(path, source))
+		{
+			// Let Lua report the missing file the way it always has
+			sol::load_result loaded = state.load_file(path);
+			m_Stats.loadNs += nowNs() - start;
+			return loaded;
+		}
+
+		const std::string chunkName = "@" + path;
+		const uint64_t sourceHash = hashString(source);
+		const fs::path cachePath = getCachePath(m_Directory, path);
+
+		std::string cached;
+		if (readFile(cachePath, cached) && cached.size() > sizeof(CacheHeader))
+		{
+			CacheHeader header;
+			memcpy(&header, cached.data(), sizeof(CacheHeader));
+
+			if (memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC)) == 0 && header.version == BYTECODE_VERSION &&
+				header.pointerSize == sizeof(void*) && header.sourceHash == sourceHash)
+			{
+				sol::load_result loaded = state.load_buffer(cached.data() + sizeof(CacheHeader), cached.size() - sizeof(CacheHeader),
+					chunkName, sol::load_mode::binary);
+
+				if (loaded.valid())
+				{
+					m_Stats.hits++;
+					m_Stats.savedNs += header.parseNs;
+					m_Stats.loadNs += nowNs() - start;
+					return loaded;
+				}
+			}
+		}
+
+		const uint64_t parseStart = nowNs();
+		sol::load_result loaded = state.load_buffer(source.data(), source.size(), chunkName, sol::load_mode::text);
+		const uint64_t parseNs = nowNs() - parseStart;
+
+		if (loaded.valid())
+			store(state, loaded, cachePath, sourceHash, parseNs);
+
+		m_Stats.loadNs += nowNs() - start;
+		return loaded;
+	}
+
+	void ScriptCache::store(sol::state_view state, const sol::load_result& loaded, const std::string& cachePath, uint64_t sourceHash, uint64_t parseNs)
+	{
+		CacheHeader header{};
+		memcpy(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+		header.version = BYTECODE_VERSION;
+		header.pointerSize = sizeof(void*);
+		header.sourceHash = sourceHash;
+		header.parseNs = parseNs;
+
+		std::string data((const char*)&header, sizeof(CacheHeader));
+
+		// The loaded chunk is on top of the stack, debug info is kept so errors still have line numbers
+		lua_State* L = state.lua_state();
+		lua_pushvalue(L, loaded.stack_index());
+		int failed = lua_dump(L, &writeChunk, &data);
+		lua_pop(L, 1);
+
+		if (failed != 0)
+			return;
+
+		fs::path file = cachePath;
+
+		// A failure here shows up as the write failing
+		std::error_code dirError;
+		fs::create_directories(file.parent_path(), dirError);
+
+		std::error_code ec;
+
+		// Written to a temporary and renamed so another instance never reads half a file
+		fs::path temp = file;
+		temp += ".tmp";
+		{
+			std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+			out.write(data.data(), (std::streamsize)data.size());
+			if (!out)
+				ec = std::make_error_code(std::errc::io_error);
+		}
+
+		if (!ec)
+			fs::rename(temp, file, ec);
+
+		if (ec)
+		{
+			fs::remove(temp, ec);
+
+			if (!m_WarnedWrite)
+			{
+				Log::log(Log::Severity::Warning, "Can't write the bytecode cache at '{}', scripts will be parsed every launch", file.parent_path().string());
+				m_WarnedWrite = true;
+			}
+		}
+	}
+}
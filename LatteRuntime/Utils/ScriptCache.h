@@ -0,0 +1,71 @@
+#ifndef LATTE_SCRIPT_CACHE_H
+#define LATTE_SCRIPT_CACHE_H
+
+#include "Singleton.h"
+#include <sol/sol.hpp>
+#include <string>
+#include <cstdint>
+
+namespace latte
+{
+	/*
+		Loads Lua scripts through a bytecode cache so startup doesn't parse the same sources every launch.
+
+		Compiled chunks are dumped to a per user directory (SDL_GetPrefPath), named after a hash of the script's
+		absolute path and tagged with a hash of its source. An entry is only used while the source still hashes
+		the same and was dumped by the same Lua build, anything stale, unreadable or rejected by the loader
+		falls back to the source and is rewritten.
+
+		LuaJIT runs bytecode without verifying it, so a cache file is as trusted as native code. Entries are
+		never kept next to the scripts, where anyone who can write to a shared or downloaded app folder could
+		plant one, only in a directory the user running the app owns
+	*/
+	class ScriptCache : public Singleton<ScriptCache>
+	{
+	public:
+
+		struct Stats
+		{
+			int scripts = 0;
+			int hits = 0;
+
+			// Time spent reading and loading scripts, not running them
+			uint64_t loadNs = 0;
+
+			// Parse time the hits would have cost, as recorded when they were cached
+			uint64_t savedNs = 0;
+		};
+
+		/*
+			Same as state.load_file, the chunk name is still @path so errors point at the source
+		*/
+		sol::load_result load(sol::state_view state, const std::string& path);
+
+		void setEnabled(bool enabled) noexcept { m_Enabled = enabled; }
+		[[nodiscard]] bool isEnabled() const noexcept { return m_Enabled; }
+
+		/*
+			Where entries are kept, it must only be writable by the user running the app.
+			Defaults to the per user preferences directory, an empty string is reset to that default
+		*/
+		void setDirectory(const std::string& directory) { m_Directory = directory; }
+		[[nodiscard]] const std::string& getDirectory();
+
+		[[nodiscard]] const Stats& getStats() const noexcept { return m_Stats; }
+
+	private:
+
+		void store(sol::state_view state, const sol::load_result& loaded, const std::string& cachePath, uint64_t sourceHash, uint64_t parseNs);
+
+		bool m_Enabled = true;
+
+		std::string m_Directory;
+
+		// Only warn once if the cache directory can't be written, e.g. a read only install
+		bool m_WarnedWrite = false;
+
+		Stats m_Stats;
+	};
+}
+
+#endif // LATTE_SCRIPT_CACHE_H
@@ -6,9 +6,14 @@
 #include "Utils/Log.h"
 #include "Router/Router.h"
 #include "Components/Focus.h"
+#include "Components/State.h"
+#include "Components/Context.h"
+#include "Components/Signal.h"
+#include "Components/ObservableList.h"
 #include "Rendering/FontMetrics.h"
 #include "OS/Clipboard.h"
 #include "Components/Core.h"
+#include "Utils/ScriptCache.h"
 #include "OS/AssetBundle.h"
 
 namespace latte
@@ -18,7 +23,7 @@ namespace latte
 	std::string g_BasePath = "luaSrc/";
 
 	void run_lua_file_with_logging(sol::state& state, const std::string& path) {
-		sol::load_result loaded = state.load_file(path);
+		sol::load_result loaded = latte::ScriptCache::getInstance().load(state, path);
 		if (!loaded.valid()) {
 			sol::error err = loaded;
 			latte::Log::log(latte::Log::Severity::Error, "Load error in '{}': {}", path, err.what());
@@ -71,6 +76,10 @@ namespace latte
 		latte::Router::luaRegister(state);
 		latte::ComponentLibrary::luaRegister(state);
 		latte::Focus::luaRegister(state);
+		latte::State::luaRegister(state);
+		latte::Context::luaRegister(state);
+		latte::Signal::luaRegister(state);
+		latte::ObservableList::luaRegister(state);
 		latte::FontMetrics::luaRegister(state);
 		latte::Clipboard::luaRegister(state);
 
@@ -78,6 +87,10 @@ namespace latte
 
 		run_lua_file_with_logging(state, path);
 
+		const ScriptCache::Stats& loadStats = ScriptCache::getInstance().getStats();
+		latte::Log::log(latte::Log::Severity::Info, "Loaded {} scripts in {:.2f} ms, {} from the bytecode cache saving ~{:.2f} ms of parsing",
+			loadStats.scripts, loadStats.loadNs / 1e6, loadStats.hits, loadStats.savedNs / 1e6);
+
 		latte::Log::log(latte::Log::Severity::Info, "Running App Event Loop");
 		latte::EventLoop::getInstance().runEventLoop(state);
 
@@ -95,6 +108,11 @@ namespace latte
 		g_BasePath = path;
 	}
 
+	void setBytecodeCacheEnabled(bool enabled)
+	{
+		ScriptCache::getInstance().setEnabled(enabled);
+	}
+
 	void registerAssets(const std::map<std::string, std::string>& assets)
 	{
 		AssetBundle::registerAssets(assets);
@@ -24,6 +24,9 @@ namespace latte
 	// Sets the base path of where latte is, so it can read Lua library files
 	void LATTEUI_API setLibBasePath(const std::string& path);
 
+	// Scripts are loaded through a bytecode cache in the user's preferences directory by default, disable it to always parse the sources
+	void LATTEUI_API setBytecodeCacheEnabled(bool enabled);
+
 	void LATTEUI_API registerAssets(const std::map<std::string, std::string>& assets);
 
 	bool LATTEUI_API hotRestart();
@@ -6,14 +6,19 @@
 #include "Utils/Log.h"
 #include "Router/Router.h"
 #include "Components/Focus.h"
+#include "Components/State.h"
+#include "Components/Context.h"
+#include "Components/Signal.h"
+#include "Components/ObservableList.h"
 #include "Rendering/FontMetrics.h"
 #include "OS/Clipboard.h"
 #include "Components/Core.h"
+#include "Utils/ScriptCache.h"
 
 sol::state state{};
 
 void run_lua_file_with_logging(sol::state& state, const std::string& path) {
-	sol::load_result loaded = state.load_file(path);
+	sol::load_result loaded = latte::ScriptCache::getInstance().load(state, path);
 	if (!loaded.valid()) {
 		sol::error err = loaded;
 		latte::Log::log(latte::Log::Severity::Error, "Load error in '{}': {}", path, err.what());
@@ -62,12 +67,20 @@ int main(int argc, char* argv)
 	latte::Router::luaRegister(state);
 	latte::ComponentLibrary::luaRegister(state);
 	latte::Focus::luaRegister(state);
+	latte::State::luaRegister(state);
+	latte::Context::luaRegister(state);
+	latte::Signal::luaRegister(state);
+	latte::ObservableList::luaRegister(state);
 	latte::FontMetrics::luaRegister(state);
 	latte::Clipboard::luaRegister(state);
 
 	latte::loadDependencyScripts(state, "luaSrc");
 
 	run_lua_file_with_logging(state, "Tests/CounterApp.lua");
+
+	const latte::ScriptCache::Stats& loadStats = latte::ScriptCache::getInstance().getStats();
+	latte::Log::log(latte::Log::Severity::Info, "Loaded {} scripts in {:.2f} ms, {} from the bytecode cache saving ~{:.2f} ms of parsing",
+		loadStats.scripts, loadStats.loadNs / 1e6, loadStats.hits, loadStats.savedNs / 1e6);
 	
 	latte::Log::log(latte::Log::Severity::Info, "Running App Event Loop");
 	latte::EventLoop::getInstance().runEventLoop(state);
@@ -0,0 +1,66 @@
+#include "TestHarness.h"
+#include "Components/Component.h"
+
+using namespace latte;
+using namespace latte::test;
+
+LATTE_TEST(contextSubscriptionsFollowTheLastBuild)
+{
+	runLua("contextTestContext = latte.createContext(0)");
+
+	defineComponents("contextTest", R"(
+		local lib, count = ...
+		return {
+			Consumer = function(props)
+				count("Consumer")
+				local state = latte.useState({ reading = true })
+				contextTestConsumer = state
+
+				if state.reading then
+					latte.useContext(contextTestContext)
+				end
+
+				return {}
+			end,
+			App = function(props)
+				count("App")
+				local state = latte.useState({ value = 1 })
+				contextTestProvider = state
+
+				return {
+					children = {
+						contextTestContext.Provider({
+							value = state.value,
+							-- Memoized so only the context can rebuild it
+							children = { lib.Consumer({ memo = true }) }
+						})
+					}
+				}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.contextTest.App({}) } }");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("contextTest", "App") == 1);
+	LATTE_CHECK(buildCount("contextTest", "Consumer") == 1);
+
+	runLua("contextTestProvider:setState({ value = 2 })");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("contextTest", "App") == 2);
+	LATTE_CHECK(buildCount("contextTest", "Consumer") == 2);
+
+	// Stops reading the context, a new value must no longer rebuild it
+	runLua("contextTestConsumer:setState({ reading = false })");
+	tree.commit();
+	LATTE_CHECK(buildCount("contextTest", "Consumer") == 3);
+
+	runLua("contextTestProvider:setState({ value = 3 })");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("contextTest", "App") == 3);
+	LATTE_CHECK(buildCount("contextTest", "Consumer") == 3);
+}
@@ -0,0 +1,66 @@
+#include "TestHarness.h"
+#include "Components/Core.h"
+#include "Utils/ScriptCache.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace latte;
+using namespace latte::test;
+
+namespace fs = std::filesystem;
+
+static void writeLibrary(const fs::path& path, const std::string& source)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out << source;
+}
+
+LATTE_TEST(lazyModulesReportFailuresAndReadThemselvesWhileLoading)
+{
+	const fs::path root = fs::temp_directory_path() / "latte-lazy-module-test";
+	std::error_code ec;
+	fs::remove_all(root, ec);
+	fs::create_directories(root);
+
+	writeLibrary(root / "latte-base.lua", "");
+
+	// Reads a key it hasn't set yet while it is being created
+	writeLibrary(root / "latte-textedit.lua", R"(
+		lazyTestSeen = latte.useMultiLineTextEdit
+		latte.useTextEdit = function() end
+		latte.useMultiLineTextEdit = 1
+	)");
+
+	writeLibrary(root / "latte-components.lua", "error('broken library')");
+
+	// Don't leave these in the user's bytecode cache
+	ScriptCache& cache = ScriptCache::getInstance();
+	const bool cacheEnabled = cache.isEnabled();
+	cache.setEnabled(false);
+
+	sol::state& state = getLuaState();
+	LATTE_CHECK(loadDependencyScripts(state, root.string() + "/"));
+
+	runLua("lazyTestLoaded = latte.useMultiLineTextEdit");
+	LATTE_CHECK(state["lazyTestSeen"].get_type() == sol::type::lua_nil);
+	LATTE_CHECK(state["lazyTestLoaded"].get<int>() == 1);
+
+	// A failed library is an error every time it is read, and so is anything that depends on it
+	for (const char* name : { "ui", "ui", "fluent" })
+	{
+		sol::protected_function_result result = state.safe_script(std::string("return latte.") + name, sol::script_pass_on_error);
+		LATTE_CHECK(!result.valid());
+		if (!result.valid())
+		{
+			sol::error err = result;
+			LATTE_CHECK(std::string(err.what()).find(".lua failed to load") != std::string::npos);
+		}
+	}
+
+	// Missing keys that no library provides are still just nil
+	runLua("assert(latte.notALibrary == nil)");
+
+	state["latte"].get<sol::table>()[sol::metatable_key] = sol::nil;
+	cache.setEnabled(cacheEnabled);
+	fs::remove_all(root, ec);
+}
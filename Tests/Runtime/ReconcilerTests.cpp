@@ -0,0 +1,683 @@
+#include "TestHarness.h"
+#include "Components/Component.h"
+#include "Components/VNode.h"
+#include "Utils/FrameArena.h"
+#include <cstdint>
+
+using namespace latte;
+using namespace latte::test;
+
+LATTE_TEST(componentRootIsComponent)
+{
+	defineComponents("rootTest", R"(
+		local lib, count = ...
+		return {
+			Inner = function(props)
+				count("Inner")
+				local children = { { id = "a" }, { id = "b" } }
+				if props.extra then
+					table.insert(children, { id = "c" })
+				end
+
+				return { direction = "vertical", children = children }
+			end,
+			Outer = function(props)
+				count("Outer")
+				return lib.Inner({ extra = props.extra })
+			end,
+			Wrapper = function(props)
+				count("Wrapper")
+				return lib.Outer({ extra = props.extra })
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.rootTest.Wrapper({}) } }");
+	tree.commit();
+
+	// Every level builds into the one node, the innermost element is what it shows
+	LatteNode* node = getChild(tree.getRoot(), 0);
+	LATTE_CHECK(tree.getRoot()->childCount == 1);
+	LATTE_CHECK(node != nullptr && node->childCount == 2);
+	LATTE_CHECK(getKey(getChild(node, 0)) == "a");
+	LATTE_CHECK(getKey(getChild(node, 1)) == "b");
+	LATTE_CHECK(node != nullptr && node->layoutDirection == LATTE_DIRECTION_VERTICAL);
+	LATTE_CHECK(buildCount("rootTest", "Wrapper") == 1);
+	LATTE_CHECK(buildCount("rootTest", "Outer") == 1);
+	LATTE_CHECK(buildCount("rootTest", "Inner") == 1);
+
+	// New props go down the whole chain and the node is kept
+	tree.mount("return { children = { latte.rootTest.Wrapper({ extra = true }) } }");
+	tree.commit();
+
+	LATTE_CHECK(getChild(tree.getRoot(), 0) == node);
+	LATTE_CHECK(node != nullptr && node->childCount == 3);
+	LATTE_CHECK(getKey(getChild(node, 2)) == "c");
+	LATTE_CHECK(buildCount("rootTest", "Wrapper") == 2);
+	LATTE_CHECK(buildCount("rootTest", "Inner") == 2);
+}
+
+LATTE_TEST(memoSkipsEqualProps)
+{
+	defineComponents("memoTest", R"(
+		local lib, count = ...
+		return {
+			Memo = function(props)
+				count("Memo")
+				return { children = { { id = props.label } } }
+			end,
+			Plain = function(props)
+				count("Plain")
+				return { children = { { id = props.label } } }
+			end
+		}
+	)");
+
+	const char* app = R"(
+		return { children = {
+			latte.memoTest.Memo({ id = "memo", memo = true, label = memoTestLabel }),
+			latte.memoTest.Plain({ id = "plain", label = "plain" })
+		} }
+	)";
+
+	runLua("memoTestLabel = 'first'");
+
+	TestTree tree;
+	tree.mount(app);
+	tree.commit();
+
+	LatteNode* memo = getChild(tree.getRoot(), 0);
+	LATTE_CHECK(buildCount("memoTest", "Memo") == 1);
+	LATTE_CHECK(buildCount("memoTest", "Plain") == 1);
+
+	// Equal props skip the memoized builder, the plain sibling always builds
+	tree.mount(app);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("memoTest", "Memo") == 1);
+	LATTE_CHECK(buildCount("memoTest", "Plain") == 2);
+	LATTE_CHECK(getKey(getChild(memo, 0)) == "first");
+
+	// A changed prop builds it again
+	runLua("memoTestLabel = 'second'");
+	tree.mount(app);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("memoTest", "Memo") == 2);
+	LATTE_CHECK(getChild(tree.getRoot(), 0) == memo);
+	LATTE_CHECK(getKey(getChild(memo, 0)) == "second");
+}
+
+LATTE_TEST(markDirtyRebuildsOnlyItsComponent)
+{
+	defineComponents("rebuildTest", R"(
+		local lib, count = ...
+		rebuildTestItems = { left = 1, right = 1 }
+		rebuildTestSpacing = 0
+
+		return {
+			Child = function(props)
+				count(props.name)
+
+				local children = {}
+				for i = 1, rebuildTestItems[props.name] do
+					table.insert(children, { id = "item" .. i })
+				end
+
+				return { children = children }
+			end,
+			Parent = function(props)
+				count("Parent")
+				return {
+					spacing = rebuildTestSpacing,
+					children = {
+						lib.Child({ name = "left" }),
+						lib.Child({ name = "right" })
+					}
+				}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.rebuildTest.Parent({}) } }");
+	tree.commit();
+
+	LatteNode* parent = getChild(tree.getRoot(), 0);
+	LatteNode* left = getChild(parent, 0);
+	LatteNode* right = getChild(parent, 1);
+	LATTE_CHECK(left != nullptr && left->childCount == 1);
+	LATTE_CHECK(buildCount("rebuildTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("rebuildTest", "left") == 1);
+	LATTE_CHECK(buildCount("rebuildTest", "right") == 1);
+
+	// Only the dirty child builds again
+	runLua("rebuildTestItems.left = 3");
+	ComponentSystem::getInstance().markDirty(left);
+	tree.commit();
+
+	LATTE_CHECK(left != nullptr && left->childCount == 3);
+	LATTE_CHECK(buildCount("rebuildTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("rebuildTest", "left") == 2);
+	LATTE_CHECK(buildCount("rebuildTest", "right") == 1);
+
+	// A dirty parent builds its children with it, once each, and they keep their nodes
+	runLua("rebuildTestSpacing = 4");
+	ComponentSystem::getInstance().markDirty(left);
+	ComponentSystem::getInstance().markDirty(parent);
+	tree.commit();
+
+	LATTE_CHECK(parent != nullptr && parent->spacing == 4.0f);
+	LATTE_CHECK(buildCount("rebuildTest", "Parent") == 2);
+	LATTE_CHECK(buildCount("rebuildTest", "left") == 3);
+	LATTE_CHECK(buildCount("rebuildTest", "right") == 2);
+	LATTE_CHECK(getChild(parent, 0) == left && getChild(parent, 1) == right);
+	LATTE_CHECK(left != nullptr && left->childCount == 3);
+}
+
+LATTE_TEST(useMemoRecomputesOnDependencyChange)
+{
+	defineComponents("useMemoTest", R"(
+		local lib, count = ...
+		useMemoTestDep = 1
+
+		return {
+			Doubled = function(props)
+				count("Doubled")
+				local dep = useMemoTestDep
+				local value = latte.useMemo(function()
+					count("compute")
+					return dep * 2
+				end, { dep })
+
+				return { spacing = value }
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.useMemoTest.Doubled({}) } }");
+	tree.commit();
+
+	LatteNode* node = getChild(tree.getRoot(), 0);
+	LATTE_CHECK(node != nullptr && node->spacing == 2.0f);
+	LATTE_CHECK(buildCount("useMemoTest", "compute") == 1);
+
+	// Same dependencies, the builder runs but the value is reused
+	ComponentSystem::getInstance().markDirty(node);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("useMemoTest", "Doubled") == 2);
+	LATTE_CHECK(buildCount("useMemoTest", "compute") == 1);
+	LATTE_CHECK(node != nullptr && node->spacing == 2.0f);
+
+	runLua("useMemoTestDep = 3");
+	ComponentSystem::getInstance().markDirty(node);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("useMemoTest", "compute") == 2);
+	LATTE_CHECK(node != nullptr && node->spacing == 6.0f);
+}
+
+LATTE_TEST(effectsRunAfterCommitWithLatestClosure)
+{
+	defineComponents("effectTest", R"(
+		local lib, count = ...
+		effectTestDep = 1
+		effectTestLabel = "a"
+
+		return {
+			Effect = function(props)
+				local label = effectTestLabel
+				latte.useEffect(function()
+					count("run")
+					effectTestSeen = label
+					return function() count("cleanup") end
+				end, { effectTestDep })
+
+				return {}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.effectTest.Effect({}) } }");
+
+	// Nothing runs until the build is committed
+	LATTE_CHECK(buildCount("effectTest", "run") == 0);
+	tree.commit();
+	LATTE_CHECK(buildCount("effectTest", "run") == 1);
+
+	// Built twice before the commit, the effect runs once with the closure from the last build
+	LatteNode* node = getChild(tree.getRoot(), 0);
+	runLua("effectTestDep = 2 effectTestLabel = 'b'");
+	ComponentSystem::getInstance().markDirty(node);
+	ComponentSystem::getInstance().performWork(UINT64_MAX);
+
+	runLua("effectTestLabel = 'c'");
+	ComponentSystem::getInstance().markDirty(node);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("effectTest", "cleanup") == 1);
+	LATTE_CHECK(buildCount("effectTest", "run") == 2);
+	LATTE_CHECK(getLuaState()["effectTestSeen"].get<std::string>() == "c");
+
+	// Same deps, nothing runs
+	ComponentSystem::getInstance().markDirty(node);
+	tree.commit();
+	LATTE_CHECK(buildCount("effectTest", "run") == 2);
+}
+
+LATTE_TEST(inputUpdatePresentsAroundUnfinishedBackgroundWork)
+{
+	defineComponents("laneTest", R"(
+		local lib, count = ...
+		laneTestDep = 1
+
+		return {
+			Item = function(props)
+				count("Item")
+				return {}
+			end,
+			List = function(props)
+				count("List")
+				return {
+					children = {
+						lib.Item({ n = 1 }),
+						lib.Item({ n = 2 }),
+						lib.Item({ n = 3 })
+					}
+				}
+			end,
+			Input = function(props)
+				local dep = laneTestDep
+				latte.useEffect(function()
+					count("effect")
+				end, { dep })
+
+				return {}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.laneTest.List({}), latte.laneTest.Input({}) } }");
+	tree.commit();
+
+	LatteNode* list = getChild(tree.getRoot(), 0);
+	LatteNode* input = getChild(tree.getRoot(), 1);
+	LATTE_CHECK(buildCount("laneTest", "Item") == 3);
+	LATTE_CHECK(buildCount("laneTest", "effect") == 1);
+
+	ComponentSystem& system = ComponentSystem::getInstance();
+	LATTE_CHECK(system.getUpdateLane() == UPDATE_LANE_BACKGROUND);
+
+	// Queued but not started, the tree on screen is still whole
+	system.markDirty(list);
+	LATTE_CHECK(system.getBusyRoots().empty());
+
+	// One unit in, the list is built and its items are still queued
+	system.performWork(0);
+	LATTE_CHECK(buildCount("laneTest", "List") == 2);
+	LATTE_CHECK(buildCount("laneTest", "Item") == 3);
+	LATTE_CHECK(system.getBusyRoots().contains(tree.getRoot()));
+
+	// Input jumps the queue but the background update it landed in the middle of isn't finished
+	runLua("laneTestDep = 2");
+	system.setUpdateLane(UPDATE_LANE_INPUT);
+	system.markDirty(input);
+	system.setUpdateLane(UPDATE_LANE_BACKGROUND);
+
+	system.performWork(0);
+	LATTE_CHECK(!system.hasWork(UPDATE_LANE_INPUT));
+	LATTE_CHECK(buildCount("laneTest", "Item") == 3);
+
+	{
+		std::pmr::unordered_set<LatteNode*> busyRoots = system.getBusyRoots();
+		LATTE_CHECK(busyRoots.contains(tree.getRoot()));
+
+		// Held back with the window, the effect waits for the update to be presented
+		system.flushEffects(&busyRoots);
+		LATTE_CHECK(buildCount("laneTest", "effect") == 1);
+	}
+
+	tree.commit();
+	LATTE_CHECK(buildCount("laneTest", "Item") == 6);
+	LATTE_CHECK(buildCount("laneTest", "effect") == 2);
+	LATTE_CHECK(system.getBusyRoots().empty());
+	FrameArena::getInstance().reset();
+}
+
+LATTE_TEST(removedDirectionResetsToHorizontal)
+{
+	defineComponents("directionTest", R"(
+		return {
+			Box = function(props)
+				local state = latte.useState({ vertical = true })
+				directionTestState = state
+
+				return { direction = state.vertical and "vertical" or nil, children = { {}, {} } }
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.directionTest.Box({}) } }");
+	tree.commit();
+
+	LatteNode* box = getChild(tree.getRoot(), 0);
+	LATTE_CHECK(box != nullptr && box->layoutDirection == LATTE_DIRECTION_VERTICAL);
+
+	runLua("directionTestState:setState({ vertical = false })");
+	tree.commit();
+
+	LATTE_CHECK(box != nullptr && box->layoutDirection == LATTE_DIRECTION_HORIZONTAL);
+}
+
+LATTE_TEST(numericTextIsConvertedToAString)
+{
+	runLua("numericTextTable = { text = 42 } numericTextFloat = { text = 1.5 } numericTextString = { text = '42' }");
+	sol::state& state = getLuaState();
+
+	VNodeBuffer buffer;
+	const VNode& number = buffer.get(buffer.build(state["numericTextTable"]));
+	LATTE_CHECK((number.flags & VNODE_FLAG_TEXT) != 0);
+	LATTE_CHECK(buffer.getText(number) == "42");
+
+	// The table keeps its number, only a copy is converted
+	LATTE_CHECK(state["numericTextTable"]["text"].get_type() == sol::type::number);
+
+	buffer.clear();
+	LATTE_CHECK(buffer.getText(buffer.get(buffer.build(state["numericTextFloat"]))) == "1.5");
+
+	// Shown the same as the string, so it fingerprints the same
+	buffer.clear();
+	const uint64_t numberFingerprint = buffer.get(buffer.build(state["numericTextTable"])).fingerprint;
+	buffer.clear();
+	LATTE_CHECK(buffer.get(buffer.build(state["numericTextString"])).fingerprint == numberFingerprint);
+}
+
+LATTE_TEST(unchangedSubtreesAreSkipped)
+{
+	defineComponents("fingerprintTest", R"(
+		local lib, count = ...
+		fingerprintTestSpacing = 2
+
+		return {
+			Panel = function(props)
+				count("Panel")
+				return {
+					children = {
+						{ id = "fixed", spacing = 1, children = { {} } },
+						{ id = "changing", spacing = fingerprintTestSpacing }
+					}
+				}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.fingerprintTest.Panel({}) } }");
+	tree.commit();
+
+	LatteNode* panel = getChild(tree.getRoot(), 0);
+	LatteNode* fixed = getChild(panel, 0);
+	LatteNode* changing = getChild(panel, 1);
+	LATTE_CHECK(fixed != nullptr && fixed->spacing == 1.0f);
+	LATTE_CHECK(changing != nullptr && changing->spacing == 2.0f);
+
+	// Changed behind the reconciler's back, so a reapplied node shows up as reset
+	fixed->spacing = 99.0f;
+	changing->spacing = 99.0f;
+
+	// The same output again, the builder runs but nothing under it is applied
+	ComponentSystem::getInstance().markDirty(panel);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("fingerprintTest", "Panel") == 2);
+	LATTE_CHECK(fixed->spacing == 99.0f);
+	LATTE_CHECK(changing->spacing == 99.0f);
+
+	// Only the node that changed is applied, its unchanged sibling is still skipped
+	runLua("fingerprintTestSpacing = 3");
+	ComponentSystem::getInstance().markDirty(panel);
+	tree.commit();
+
+	LATTE_CHECK(fixed->spacing == 99.0f);
+	LATTE_CHECK(changing->spacing == 3.0f);
+}
+
+LATTE_TEST(staticSubtreesAreFrozenUntilReplaced)
+{
+	defineComponents("staticTest", R"(
+		local lib, count = ...
+		-- What latte.static does, the harness doesn't load luaSrc
+		staticTestA = { __latte_static = true, spacing = 1, children = { { spacing = 5 } } }
+		staticTestB = { __latte_static = true, spacing = 2, children = { { spacing = 6 } } }
+		staticTestOrder = { staticTestA, staticTestB }
+
+		return {
+			Panel = function(props)
+				count("Panel")
+				return { children = staticTestOrder }
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.staticTest.Panel({}) } }");
+	tree.commit();
+
+	ComponentSystem& system = ComponentSystem::getInstance();
+	sol::state& state = getLuaState();
+	LATTE_CHECK(system.findFrozenTable(state["staticTestA"].get<sol::table>().pointer()) != nullptr);
+	LATTE_CHECK(system.findFrozenTable(state["staticTestB"].get<sol::table>().pointer()) != nullptr);
+
+	LatteNode* panel = getChild(tree.getRoot(), 0);
+	LatteNode* first = getChild(panel, 0);
+	LatteNode* second = getChild(panel, 1);
+	LATTE_CHECK(first != nullptr && first->spacing == 1.0f);
+	LATTE_CHECK(second != nullptr && second->spacing == 2.0f);
+
+	// Frozen tables aren't read again, so the tampered values survive a rebuild
+	getChild(first, 0)->spacing = 99.0f;
+	system.markDirty(panel);
+	tree.commit();
+
+	LATTE_CHECK(buildCount("staticTest", "Panel") == 2);
+	LATTE_CHECK(getChild(first, 0)->spacing == 99.0f);
+
+	// Swapped, each position now holds a different frozen table and is applied again
+	runLua("staticTestOrder = { staticTestB, staticTestA }");
+	system.markDirty(panel);
+	tree.commit();
+
+	LATTE_CHECK(first->spacing == 2.0f && getChild(first, 0)->spacing == 6.0f);
+	LATTE_CHECK(second->spacing == 1.0f && getChild(second, 0)->spacing == 5.0f);
+
+	// A new static table in the same place replaces the frozen one
+	runLua("staticTestOrder = { { __latte_static = true, spacing = 7, children = { { spacing = 8 } } }, staticTestA }");
+	system.markDirty(panel);
+	tree.commit();
+
+	LATTE_CHECK(first->spacing == 7.0f && getChild(first, 0)->spacing == 8.0f);
+	LATTE_CHECK(system.findFrozenTable(state["staticTestB"].get<sol::table>().pointer()) == nullptr);
+}
+
+// Every item's childIndex matches where it is in the list
+static bool listIndicesMatch(LatteNode* list)
+{
+	for (int i = 0; i < list->childCount; i++)
+	{
+		if (getData(list->children[i])->childIndex != i)
+			return false;
+	}
+
+	return true;
+}
+
+LATTE_TEST(observableListInsertMoveRemove)
+{
+	runLua("listTestItems = latte.ObservableList({ 'a', 'b', 'c' })");
+
+	defineComponents("listTest", R"(
+		local lib, count = ...
+		return {
+			Item = function(props)
+				count(props.name)
+				return {}
+			end,
+			List = function(props)
+				count("List")
+
+				return {
+					items = listTestItems,
+					itemBuilder = function(value)
+						return lib.Item({ id = value, name = value })
+					end
+				}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.listTest.List({}) } }");
+	tree.commit();
+
+	LatteNode* list = getChild(tree.getRoot(), 0);
+	LATTE_CHECK(list != nullptr && list->childCount == 3);
+	LATTE_CHECK(getKey(getChild(list, 0)) == "a");
+	LATTE_CHECK(getKey(getChild(list, 1)) == "b");
+	LATTE_CHECK(getKey(getChild(list, 2)) == "c");
+
+	LatteNode* a = getChild(list, 0);
+	LatteNode* b = getChild(list, 1);
+	LatteNode* c = getChild(list, 2);
+
+	// Only the new item is built, the others keep their nodes
+	runLua("listTestItems:insert(2, 'x')");
+	tree.commit();
+
+	LATTE_CHECK(list != nullptr && list->childCount == 4);
+	LATTE_CHECK(getChild(list, 0) == a);
+	LATTE_CHECK(getKey(getChild(list, 1)) == "x");
+	LATTE_CHECK(getChild(list, 2) == b);
+	LATTE_CHECK(getChild(list, 3) == c);
+	LATTE_CHECK(buildCount("listTest", "x") == 1);
+	LATTE_CHECK(buildCount("listTest", "a") == 1);
+	LATTE_CHECK(buildCount("listTest", "List") == 1);
+	LATTE_CHECK(listIndicesMatch(list));
+
+	// A move reorders the nodes without building anything
+	runLua("listTestItems:move(1, 4)");
+	tree.commit();
+
+	LATTE_CHECK(list != nullptr && list->childCount == 4);
+	LATTE_CHECK(getKey(getChild(list, 0)) == "x");
+	LATTE_CHECK(getChild(list, 1) == b);
+	LATTE_CHECK(getChild(list, 2) == c);
+	LATTE_CHECK(getChild(list, 3) == a);
+	LATTE_CHECK(buildCount("listTest", "a") == 1);
+	LATTE_CHECK(listIndicesMatch(list));
+
+	runLua("listTestItems:remove(2)");
+	tree.commit();
+
+	LATTE_CHECK(list != nullptr && list->childCount == 3);
+	LATTE_CHECK(getKey(getChild(list, 0)) == "x");
+	LATTE_CHECK(getChild(list, 1) == c);
+	LATTE_CHECK(getChild(list, 2) == a);
+	LATTE_CHECK(buildCount("listTest", "List") == 1);
+	LATTE_CHECK(buildCount("listTest", "b") == 1);
+	LATTE_CHECK(listIndicesMatch(list));
+}
+
+LATTE_TEST(removedSubtreesAreDestroyedLater)
+{
+	defineComponents("destroyTest", R"(
+		local lib, count = ...
+		return {
+			Child = function(props)
+				latte.useEffect(function()
+					count("effect")
+					return function() count("cleanup") end
+				end, {})
+
+				local children = {}
+				for i = 1, 100 do
+					children[i] = { id = "leaf" .. i }
+				end
+
+				return { children = children }
+			end,
+			Parent = function(props)
+				local state = latte.useState({ shown = true })
+				destroyTestState = state
+
+				local children = {}
+				if state.shown then
+					children[1] = lib.Child({})
+				end
+
+				return { children = children }
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.destroyTest.Parent({}) } }");
+	tree.commit();
+
+	LatteNode* parent = getChild(tree.getRoot(), 0);
+	LatteNode* child = getChild(parent, 0);
+	LATTE_CHECK(child != nullptr && child->childCount == 100);
+	LATTE_CHECK(buildCount("destroyTest", "effect") == 1);
+	LATTE_CHECK(buildCount("destroyTest", "cleanup") == 0);
+
+	ComponentSystem& system = ComponentSystem::getInstance();
+
+	// Removing it only detaches it, nothing is freed and no cleanup runs during the build
+	runLua("destroyTestState:setState({ shown = false })");
+	system.performWork(UINT64_MAX);
+	system.flushEffects();
+
+	LATTE_CHECK(parent != nullptr && parent->childCount == 0);
+	LATTE_CHECK(getData(child) != nullptr && getData(child)->detached);
+	LATTE_CHECK(buildCount("destroyTest", "cleanup") == 0);
+
+	// With no time left a slice still frees some leaves, the component itself goes last
+	LATTE_CHECK(!system.destroyDetached(0));
+	LATTE_CHECK(buildCount("destroyTest", "cleanup") == 0);
+
+	int slices = 1;
+	while (!system.destroyDetached(0) && slices < 16)
+		slices++;
+
+	LATTE_CHECK(slices < 16);
+	LATTE_CHECK(buildCount("destroyTest", "cleanup") == 1);
+	LATTE_CHECK(buildCount("destroyTest", "effect") == 1);
+
+	FrameArena::getInstance().reset();
+}
+
+LATTE_TEST(getIDReturnsTheReadablePath)
+{
+	defineComponents("idTest", R"(
+		return {
+			Named = function(props)
+				idTestPath = latte.getID()
+				idTestHash = latte.getIDHash()
+				return {}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.idTest.Named({ id = 'named' }) } }");
+	tree.commit();
+
+	sol::state& state = getLuaState();
+	LATTE_CHECK(state["idTestPath"].get<std::string>() == "test_root/named");
+	LATTE_CHECK(state["idTestHash"].get<std::string>().size() == 16);
+}
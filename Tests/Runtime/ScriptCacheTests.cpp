@@ -0,0 +1,73 @@
+#include "TestHarness.h"
+#include "Utils/ScriptCache.h"
+#include <filesystem>
+#include <fstream>
+
+using namespace latte;
+using namespace latte::test;
+
+namespace fs = std::filesystem;
+
+static void writeScript(const fs::path& path, const std::string& source)
+{
+	std::ofstream out(path, std::ios::binary | std::ios::trunc);
+	out << source;
+}
+
+// Loads and runs a script through the cache, -1 if it didn't load or return a number
+static int runCached(const fs::path& path)
+{
+	sol::load_result loaded = ScriptCache::getInstance().load(getLuaState(), path.string());
+	if (!loaded.valid())
+		return -1;
+
+	sol::protected_function func = loaded;
+	sol::protected_function_result result = func();
+	return result.valid() && result.get_type() == sol::type::number ? result.get<int>() : -1;
+}
+
+LATTE_TEST(scriptCacheHitsMissesAndInvalidates)
+{
+	const fs::path root = fs::temp_directory_path() / "latte-script-cache-test";
+	std::error_code ec;
+	fs::remove_all(root, ec);
+	fs::create_directories(root / "scripts");
+
+	ScriptCache& cache = ScriptCache::getInstance();
+	cache.setDirectory((root / "cache").string());
+
+	const fs::path script = root / "scripts" / "app.lua";
+	writeScript(script, "return 1");
+
+	// First load parses the source and writes an entry
+	const int hits = cache.getStats().hits;
+	LATTE_CHECK(runCached(script) == 1);
+	LATTE_CHECK(cache.getStats().hits == hits);
+
+	int entries = 0;
+	for (const fs::directory_entry& entry : fs::directory_iterator(root / "cache", ec))
+		entries += entry.path().extension() == ".bc" ? 1 : 0;
+	LATTE_CHECK(entries == 1);
+
+	// Nothing is written next to the script
+	LATTE_CHECK(!fs::exists(root / "scripts" / ".latte-cache"));
+
+	LATTE_CHECK(runCached(script) == 1);
+	LATTE_CHECK(cache.getStats().hits == hits + 1);
+
+	// An edited source misses and replaces the entry, which is then hit
+	writeScript(script, "return 2");
+	LATTE_CHECK(runCached(script) == 2);
+	LATTE_CHECK(cache.getStats().hits == hits + 1);
+	LATTE_CHECK(runCached(script) == 2);
+	LATTE_CHECK(cache.getStats().hits == hits + 2);
+
+	// A damaged entry falls back to the source
+	for (const fs::directory_entry& entry : fs::directory_iterator(root / "cache", ec))
+		writeScript(entry.path(), "not bytecode");
+	LATTE_CHECK(runCached(script) == 2);
+	LATTE_CHECK(cache.getStats().hits == hits + 2);
+
+	cache.setDirectory("");
+	fs::remove_all(root, ec);
+}
@@ -0,0 +1,60 @@
+#include "TestHarness.h"
+#include "Components/Signal.h"
+#include "Components/VNode.h"
+
+using namespace latte;
+using namespace latte::test;
+
+LATTE_TEST(signalValuesAreReadAndSet)
+{
+	runLua(R"(
+		signalTestSignal = latte.signal(1)
+		signalTestFirst = signalTestSignal:get()
+		signalTestSignal:set(2)
+		signalTestSecond = signalTestSignal.value
+		signalTestSignal.value = "three"
+	)");
+
+	sol::state& state = getLuaState();
+	LATTE_CHECK(state["signalTestFirst"].get<int>() == 1);
+	LATTE_CHECK(state["signalTestSecond"].get<int>() == 2);
+
+	std::shared_ptr<Signal> signal = state["signalTestSignal"];
+	LATTE_CHECK(signal->getText() == "three");
+
+	// Numbers are formatted, anything else has no text
+	signal->set(sol::make_object(state, 4.5));
+	LATTE_CHECK(signal->getText() == "4.5");
+	signal->set(sol::make_object(state, true));
+	LATTE_CHECK(signal->getText().empty());
+}
+
+LATTE_TEST(boundSignalsIdentifyTheNode)
+{
+	runLua(R"(
+		signalTestText = latte.signal(3)
+		signalTestOther = latte.signal(3)
+		signalTestNode = { text = signalTestText }
+		signalTestOtherNode = { text = signalTestOther }
+	)");
+
+	sol::state& state = getLuaState();
+
+	VNodeBuffer buffer;
+	const VNode& node = buffer.get(buffer.build(state["signalTestNode"]));
+	LATTE_CHECK(node.signalCount == 1 && buffer.getSignals(node)[0].field == SIGNAL_FIELD_TEXT);
+	LATTE_CHECK(buffer.getText(node) == "3");
+	const uint64_t fingerprint = node.fingerprint;
+
+	// A new value is patched straight onto the node, so a rebuild with the same signal can still be skipped
+	runLua("signalTestText:set(4)");
+	buffer.clear();
+	const VNode& rebuilt = buffer.get(buffer.build(state["signalTestNode"]));
+	LATTE_CHECK(buffer.getText(rebuilt) == "4");
+	LATTE_CHECK(rebuilt.fingerprint == fingerprint);
+
+	// A different signal has to be bound, even with the same value
+	runLua("signalTestOther:set(4)");
+	buffer.clear();
+	LATTE_CHECK(buffer.get(buffer.build(state["signalTestOtherNode"])).fingerprint != fingerprint);
+}
@@ -0,0 +1,144 @@
+#include "TestHarness.h"
+#include "Components/Component.h"
+
+using namespace latte;
+using namespace latte::test;
+
+LATTE_TEST(setStateRebuildsOnlyItsComponent)
+{
+	defineComponents("setStateTest", R"(
+		local lib, count = ...
+		setStateTestChildren = {}
+
+		return {
+			Child = function(props)
+				count(props.name)
+				local state = latte.useState({ items = 1 })
+				setStateTestChildren[props.name] = state
+
+				local children = {}
+				for i = 1, state.items do
+					table.insert(children, { id = "item" .. i })
+				end
+
+				return { children = children }
+			end,
+			Parent = function(props)
+				count("Parent")
+				local state = latte.useState({ spacing = 0 })
+				setStateTestParent = state
+
+				return {
+					spacing = state.spacing,
+					children = {
+						lib.Child({ name = "left" }),
+						lib.Child({ name = "right" })
+					}
+				}
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.setStateTest.Parent({}) } }");
+	tree.commit();
+
+	LatteNode* parent = getChild(tree.getRoot(), 0);
+	LatteNode* left = getChild(parent, 0);
+	LatteNode* right = getChild(parent, 1);
+	LATTE_CHECK(left != nullptr && left->childCount == 1);
+
+	// Only the child that set state builds again
+	runLua("setStateTestChildren.left:setState({ items = 3 })");
+	tree.commit();
+
+	LATTE_CHECK(left != nullptr && left->childCount == 3);
+	LATTE_CHECK(buildCount("setStateTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("setStateTest", "left") == 2);
+	LATTE_CHECK(buildCount("setStateTest", "right") == 1);
+
+	// Setting the same value again is not a change
+	runLua("setStateTestChildren.left:setState({ items = 3 })");
+	tree.commit();
+	LATTE_CHECK(buildCount("setStateTest", "left") == 2);
+
+	// A parent rebuild builds its children with it, and they keep their nodes and state
+	runLua("setStateTestParent:setState({ spacing = 4 })");
+	tree.commit();
+
+	LATTE_CHECK(parent != nullptr && parent->spacing == 4.0f);
+	LATTE_CHECK(buildCount("setStateTest", "Parent") == 2);
+	LATTE_CHECK(buildCount("setStateTest", "left") == 3);
+	LATTE_CHECK(buildCount("setStateTest", "right") == 2);
+	LATTE_CHECK(getChild(parent, 0) == left && getChild(parent, 1) == right);
+	LATTE_CHECK(left != nullptr && left->childCount == 3);
+}
+
+LATTE_TEST(childReadsParentState)
+{
+	defineComponents("sharedStateTest", R"(
+		local lib, count = ...
+		return {
+			Counter = function(props)
+				count("Counter")
+
+				local children = {}
+				for i = 1, props.state.count do
+					table.insert(children, { id = "item" .. i })
+				end
+
+				return { children = children }
+			end,
+			Parent = function(props)
+				count("Parent")
+				local state = latte.useState({ count = 1, shown = true, unread = 0 })
+				sharedState = state
+
+				local children = {}
+				if state.shown then
+					table.insert(children, lib.Counter({ state = state }))
+				end
+
+				return { children = children }
+			end
+		}
+	)");
+
+	TestTree tree;
+	tree.mount("return { children = { latte.sharedStateTest.Parent({}) } }");
+	tree.commit();
+
+	LatteNode* parent = getChild(tree.getRoot(), 0);
+	LatteNode* counter = getChild(parent, 0);
+	LATTE_CHECK(counter != nullptr && counter->childCount == 1);
+	LATTE_CHECK(buildCount("sharedStateTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("sharedStateTest", "Counter") == 1);
+
+	// Only the child read count, so only it rebuilds
+	runLua("sharedState:setState({ count = 2 })");
+	tree.commit();
+
+	LATTE_CHECK(counter != nullptr && counter->childCount == 2);
+	LATTE_CHECK(buildCount("sharedStateTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("sharedStateTest", "Counter") == 2);
+
+	// Nothing read this key
+	runLua("sharedState.unread = 1");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("sharedStateTest", "Parent") == 1);
+	LATTE_CHECK(buildCount("sharedStateTest", "Counter") == 2);
+
+	// The owner read shown, removing the child must also stop it being tracked as a reader
+	runLua("sharedState:setState({ shown = false })");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("sharedStateTest", "Parent") == 2);
+	LATTE_CHECK(parent != nullptr && parent->childCount == 0);
+
+	runLua("sharedState:setState({ count = 3 })");
+	tree.commit();
+
+	LATTE_CHECK(buildCount("sharedStateTest", "Parent") == 2);
+	LATTE_CHECK(buildCount("sharedStateTest", "Counter") == 2);
+}
@@ -0,0 +1,221 @@
+#include "TestHarness.h"
+#include <SDL3/SDL.h>
+#include "Components/Component.h"
+#include "Components/ComponentLibrary.h"
+#include "Components/Core.h"
+#include "Components/State.h"
+#include "Components/Context.h"
+#include "Components/ObservableList.h"
+#include "Components/Signal.h"
+#include "Utils/FrameArena.h"
+#include "Utils/Log.h"
+#include <cstdint>
+#include <cstring>
+
+namespace latte::test
+{
+	static const char* s_CurrentTest = "";
+	static int s_Failures = 0;
+
+	std::vector<TestCase>& getTestCases()
+	{
+		static std::vector<TestCase> s_Tests;
+		return s_Tests;
+	}
+
+	void reportFailure(const char* expression, const char* file, int line)
+	{
+		Log::log(Log::Severity::Error, "{} failed: {} ({}:{})", s_CurrentTest, expression, file, line);
+		s_Failures++;
+	}
+
+	sol::state& getLuaState()
+	{
+		// Never freed, the runtime singletons hold references into it until exit
+		static sol::state* s_State = new sol::state();
+		return *s_State;
+	}
+
+	void runLua(const std::string& code)
+	{
+		sol::protected_function_result result = getLuaState().safe_script(code, sol::script_pass_on_error);
+		if (!result.valid())
+		{
+			sol::error err = result;
+			reportFailure(err.what(), "<lua>", 0);
+		}
+	}
+
+	// Loads a chunk of Lua, an invalid function if it does not compile
+	static sol::protected_function loadLua(const std::string& code)
+	{
+		sol::load_result chunk = getLuaState().load(code);
+		if (!chunk.valid())
+		{
+			sol::error err = chunk;
+			reportFailure(err.what(), "<lua>", 0);
+			return sol::protected_function();
+		}
+
+		return chunk.get<sol::protected_function>();
+	}
+
+	template<typename... Args>
+	static sol::object callLua(const sol::protected_function& func, Args&&... args)
+	{
+		if (!func.valid())
+			return sol::nil;
+
+		sol::protected_function_result result = func(std::forward<Args>(args)...);
+		if (!result.valid())
+		{
+			sol::error err = result;
+			reportFailure(err.what(), "<lua>", 0);
+			return sol::nil;
+		}
+
+		return result.get<sol::object>();
+	}
+
+	static sol::table getCounts(const std::string& library)
+	{
+		sol::state& state = getLuaState();
+		sol::table counts = state["__latte_test_counts"].get_or_create<sol::table>();
+		return counts[library].get_or_create<sol::table>();
+	}
+
+	void defineComponents(const std::string& library, const std::string& source)
+	{
+		sol::state& state = getLuaState();
+		std::shared_ptr<ComponentLibrary> lib = ComponentSystem::getInstance().createComponentLibrary(library);
+
+		sol::table counts = getCounts(library);
+		auto count = [counts](const std::string& name) mutable {
+			counts[name] = counts.get_or(name, 0) + 1;
+			};
+
+		sol::object components = callLua(loadLua(source), state["latte"][library].get<sol::object>(), count);
+		if (!components.is<sol::table>())
+		{
+			reportFailure("components table", "<lua>", 0);
+			return;
+		}
+
+		lib->registerComponentList(components.as<sol::table>());
+	}
+
+	int buildCount(const std::string& library, const std::string& name)
+	{
+		sol::optional<int> count = getCounts(library)[name].get<sol::optional<int>>();
+		return count.value_or(0);
+	}
+
+	TestTree::TestTree()
+	{
+		m_Root = latteCreateNode("test_root", nullptr, LATTE_NODE_FLAGS_DELETE_USERDATA);
+	}
+
+	TestTree::~TestTree()
+	{
+		ComponentSystem& system = ComponentSystem::getInstance();
+		while (m_Root->childCount > 0)
+			system.detachNode(m_Root->children[m_Root->childCount - 1]);
+
+		commit();
+		latteFreeNode(m_Root);
+	}
+
+	void TestTree::mount(const sol::table& table)
+	{
+		ComponentSystem& system = ComponentSystem::getInstance();
+		system.pushNode(m_Root);
+		applyPropsFromTable(m_Root, table, false);
+		system.popNode();
+	}
+
+	void TestTree::mount(const std::string& source)
+	{
+		sol::object table = callLua(loadLua(source));
+		if (table.is<sol::table>())
+			mount(table.as<sol::table>());
+	}
+
+	void TestTree::commit()
+	{
+		ComponentSystem& system = ComponentSystem::getInstance();
+		system.performWork(UINT64_MAX);
+		(void)system.takeChanges();
+		system.flushEffects();
+		system.destroyDetached(UINT64_MAX);
+		FrameArena::getInstance().reset();
+	}
+
+	LatteNode* getChild(LatteNode* node, int index)
+	{
+		if (node == nullptr || index < 0 || index >= node->childCount)
+			return nullptr;
+
+		return node->children[index];
+	}
+
+	ComponentData* getData(LatteNode* node)
+	{
+		return node ? (ComponentData*)latteGetUserData(node) : nullptr;
+	}
+
+	std::string getKey(LatteNode* node)
+	{
+		ComponentData* data = getData(node);
+		return data ? data->key : std::string();
+	}
+}
+
+int main(int argc, char** argv)
+{
+	// Only the clock is used, nothing opens a window
+	if (!SDL_Init(SDL_INIT_EVENTS))
+	{
+		latte::Log::log(latte::Log::Severity::Fatal, "Failed to initialise SDL3: {}", SDL_GetError());
+		return -1;
+	}
+
+	sol::state& state = latte::test::getLuaState();
+	state.open_libraries(
+		sol::lib::base,
+		sol::lib::math,
+		sol::lib::table,
+		sol::lib::string
+	);
+
+	latte::ComponentSystem::getInstance().setState(&state);
+
+	latte::bindCoreFunctions(state);
+
+	latte::ComponentLibrary::luaRegister(state);
+	latte::State::luaRegister(state);
+	latte::Context::luaRegister(state);
+	latte::ObservableList::luaRegister(state);
+	latte::Signal::luaRegister(state);
+
+	// An optional name runs just that test
+	const char* filter = argc > 1 ? argv[1] : nullptr;
+
+	int run = 0;
+	for (const latte::test::TestCase& test : latte::test::getTestCases())
+	{
+		if (filter && strcmp(filter, test.name) != 0)
+			continue;
+
+		latte::test::s_CurrentTest = test.name;
+		const int failuresBefore = latte::test::s_Failures;
+
+		test.func();
+		run++;
+
+		if (latte::test::s_Failures == failuresBefore)
+			latte::Log::log(latte::Log::Severity::Info, "{} passed", test.name);
+	}
+
+	latte::Log::log(latte::Log::Severity::Info, "{} tests run, {} failures", run, latte::test::s_Failures);
+	return latte::test::s_Failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,103 @@
+#ifndef LATTE_TEST_HARNESS_H
+#define LATTE_TEST_HARNESS_H
+
+#include <sol/sol.hpp>
+extern "C" {
+#include <LatteLayout/layout.h>
+}
+#include <string>
+#include <vector>
+
+namespace latte
+{
+	struct ComponentData;
+}
+
+namespace latte::test
+{
+	using TestFunc = void(*)();
+
+	struct TestCase
+	{
+		const char* name;
+		TestFunc func;
+	};
+
+	std::vector<TestCase>& getTestCases();
+
+	struct TestRegistrar
+	{
+		TestRegistrar(const char* name, TestFunc func) { getTestCases().push_back({ name, func }); }
+	};
+
+	void reportFailure(const char* expression, const char* file, int line);
+
+	/*
+		The Lua state every test runs in, it has the same bindings as the runtime but none of the luaSrc libraries
+	*/
+	sol::state& getLuaState();
+
+	/*
+		Runs a chunk of Lua, an error fails the current test
+	*/
+	void runLua(const std::string& code);
+
+	/*
+		Registers a component library built from a chunk of Lua that returns its components.
+		The chunk gets the library's table, so components can use each other, and count(name)
+		which records a build, an effect or anything else a test wants to count.
+		Every test uses its own library name
+	*/
+	void defineComponents(const std::string& library, const std::string& source);
+
+	// How many times count(name) ran in a library's components
+	int buildCount(const std::string& library, const std::string& name);
+
+	/*
+		A window root without a window, so the reconciler can be driven without SDL video or a renderer.
+		Anything mounted is freed when the tree goes out of scope
+	*/
+	class TestTree
+	{
+	public:
+
+		TestTree();
+		~TestTree();
+
+		/*
+			Builds the root from a table like a window builds its root table,
+			the string form runs a chunk of Lua that returns the table
+		*/
+		void mount(const sol::table& table);
+		void mount(const std::string& source);
+
+		/*
+			Finishes whatever the last mount or state change left for the event loop to do
+		*/
+		void commit();
+
+		[[nodiscard]] LatteNode* getRoot() const noexcept { return m_Root; }
+
+	private:
+
+		LatteNode* m_Root = nullptr;
+	};
+
+	// nullptr when the index is out of range
+	LatteNode* getChild(LatteNode* node, int index);
+
+	ComponentData* getData(LatteNode* node);
+
+	// The id a child was given, empty if it has none
+	std::string getKey(LatteNode* node);
+}
+
+#define LATTE_TEST(name) \
+	static void name(); \
+	static latte::test::TestRegistrar name##Registrar(#name, name); \
+	static void name()
+
+#define LATTE_CHECK(expression) \
+	do { if (!(expression)) latte::test::reportFailure(#expression, __FILE__, __LINE__); } while (0)
+
+#endif // LATTE_TEST_HARNESS_H
@@ -1,7 +1,10 @@
 
 
+-- mergeStyles, mergeProps and color.hex are native in the runtime,
+-- the versions here are only used when the runtime doesn't provide them
+
 -- Merges two style tables, with style2 overwriting matching keys in style1
-latte.mergeStyles = function(style1, style2)
+latte.mergeStyles = latte.mergeStyles or function(style1, style2)
 	local result = {}
     -- Copy all key/value pairs from style1
     for k, v in pairs(style1) do
@@ -15,7 +18,7 @@ latte.mergeStyles = function(style1, style2)
 end
 
 -- Merges two property tables, excluding certain keys from being overwritten
-function latte.mergeProps(base, exclude, extra)
+latte.mergeProps = latte.mergeProps or function(base, exclude, extra)
     local result = {}
     for k, v in pairs(base) do result[k] = v end
 
@@ -33,6 +36,23 @@ function latte.mergeProps(base, exclude, extra)
     return result
 end
 
+-- Wraps a component so it is only rebuilt when its props change
+-- Props are shallow compared, so pass stable tables/functions to get the benefit
+function latte.memo(component)
+    return function(props)
+        local descriptor = component(props)
+        descriptor.memo = true
+        return descriptor
+    end
+end
+
+-- Marks a table of plain elements as never changing
+-- Once mounted the table is skipped on every rebuild, so it must be created once outside the component
+function latte.static(element)
+    element.__latte_static = true
+    return element
+end
+
 -- Padding helper functions
 -- Padding is just a table of 4 values: { left, top, right, bottom }
 
@@ -89,7 +109,7 @@ latte.borderRadius.ltrb = function(left, top, right, bottom)
 end
 
 -- Latte expects colors in a table, with [1] = r, [2] = g, [3] = b, [4] = a, these are in float format (0.0 - 1.0)
-latte.color = {}
+latte.color = latte.color or {}
 
 -- Create a color from 0 - 255 RGB, A is optional, 0.0 - 1.0 and defaults to 1.0
 latte.color.rgba = function(r, g, b, a)
@@ -97,7 +117,11 @@ latte.color.rgba = function(r, g, b, a)
 end
 
 -- Takes a hex color string like "#RGB" or "#RGBA" "#RRGGBB" or "#RRGGBBAA" and returns a color table
-latte.color.hex = function(hex)
+-- Results are cached so the same string always gives the same table, don't modify it
+local hexCache = {}
+local hexCacheSize = 0
+
+local function parseHex(hex)
     local r, g, b, a
     if string.sub(hex, 1, 1) == "#" then
         hex = string.sub(hex, 2)
@@ -123,12 +147,30 @@ latte.color.hex = function(hex)
         b = tonumber("0x" .. string.sub(hex, 5, 6)) / 255
         a = tonumber("0x" .. string.sub(hex, 7, 8)) / 255
     else
-        error("Invalid hex color format")
+        error("Invalid hex color format", 3)
     end
 
     return { r, g, b, a }
 end
 
+latte.color.hex = latte.color.hex or function(hex)
+    local color = hexCache[hex]
+    if color then
+        return color
+    end
+
+    -- Dropped when full so generated color strings can't grow it forever
+    if hexCacheSize >= 1024 then
+        hexCache = {}
+        hexCacheSize = 0
+    end
+
+    color = parseHex(hex)
+    hexCache[hex] = color
+    hexCacheSize = hexCacheSize + 1
+    return color
+end
+
 -- Create a color table from hsla values
 latte.color.hsla = function(h, s, l, a)
     a = a or 1.0
@@ -318,4 +360,79 @@ latte.color.wheat = latte.color.hex("#F5DEB3")
 latte.color.white = latte.color.hex("#FFFFFF")
 latte.color.whitesmoke = latte.color.hex("#F5F5F5")
 latte.color.yellow = latte.color.hex("#FFFF00")
-latte.color.yellowgreen = latte.color.hex("#9ACD32")
\ No newline at end of file
+latte.color.yellowgreen = latte.color.hex("#9ACD32")
+-- FFI fast paths
+-- Under LuaJIT focus and font metric calls go straight to the engine's C functions through the FFI,
+-- which the JIT can compile, instead of through the sol usertypes. Plain Lua keeps the usertypes.
+-- Both give back objects with the same methods, the sol versions are kept in latte.fastPaths.sol
+latte.fastPaths = {
+    enabled = false,
+    sol = {
+        useFocus = latte.useFocus,
+        getFontMetrics = latte.getFontMetrics,
+    },
+}
+
+local hasFFI, ffi = pcall(require, "ffi")
+if jit and hasFFI and latte.__ffi then
+    local native = latte.__ffi
+
+    local currentNodeId = ffi.cast("uint64_t (*)(void)", native.currentNodeId)
+    local isFocused = ffi.cast("bool (*)(uint64_t)", native.isFocused)
+    local requestFocus = ffi.cast("void (*)(uint64_t)", native.requestFocus)
+    local textSize = ffi.cast("float (*)(const char*, float, const char*, size_t, float*)", native.textSize)
+    local lineHeight = ffi.cast("float (*)(const char*, float)", native.lineHeight)
+
+    -- Reused by every call, only one measurement runs at a time
+    local height = ffi.new("float[1]")
+
+    local Focus = {}
+    Focus.__index = Focus
+
+    function Focus:isFocused()
+        return isFocused(self.id)
+    end
+
+    function Focus:request()
+        requestFocus(self.id)
+    end
+
+    -- A handle is the id in a struct, no table and no separate boxed uint64_t
+    ffi.cdef("typedef struct { uint64_t id; } LatteFocusHandle;")
+    local FocusHandle = ffi.metatype("LatteFocusHandle", Focus)
+
+    -- Every build of a component gets the handle it had last time, weak so handles of freed nodes are collected.
+    -- Keyed by the low 52 bits, which fit a Lua number exactly, the full id is checked in case two nodes share them
+    local focusHandles = setmetatable({}, { __mode = "v" })
+
+    latte.useFocus = function()
+        local id = currentNodeId()
+        local key = tonumber(id % 2 ^ 52)
+
+        local handle = focusHandles[key]
+        if handle == nil or handle.id ~= id then
+            handle = FocusHandle(id)
+            focusHandles[key] = handle
+        end
+
+        return handle
+    end
+
+    local FontMetrics = {}
+    FontMetrics.__index = FontMetrics
+
+    function FontMetrics:getTextSize(str)
+        local width = textSize(self.fontFace, self.fontSize, str, #str, height)
+        return { width = width, height = height[0] }
+    end
+
+    function FontMetrics:getLineHeight()
+        return lineHeight(self.fontFace, self.fontSize)
+    end
+
+    latte.getFontMetrics = function(fontFace, fontSize)
+        return setmetatable({ fontFace = fontFace, fontSize = fontSize }, FontMetrics)
+    end
+
+    latte.fastPaths.enabled = true
+end